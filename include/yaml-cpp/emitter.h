@@ -31,6 +31,8 @@ namespace YAML {
 class EmitterState;
 
 class YAML_CPP_API Emitter {
+  friend class EmitFromEvents;
+
  public:
   Emitter();
   explicit Emitter(std::ostream& stream);
@@ -59,6 +61,7 @@ class YAML_CPP_API Emitter {
   bool SetPostCommentIndent(std::size_t n);
   bool SetFloatPrecision(std::size_t n);
   bool SetDoublePrecision(std::size_t n);
+  bool SetOutputFormat(EMITTER_MANIP value);
   void RestoreGlobalModifiedSettings();
 
   // local setters
@@ -90,8 +93,15 @@ class YAML_CPP_API Emitter {
   std::size_t GetDoublePrecision() const;
 
   void PrepareIntegralStream(std::stringstream& stream) const;
+  void WriteNumber(const std::string& number, bool finite);
   void StartedScalar();
 
+  // WritePlainScalar
+  // . Writes a node's scalar whose tag is non-specific, i.e. one that was
+  //   plain, so that in JSON output it stays bare if it reads as a number,
+  //   bool or null
+  Emitter& WritePlainScalar(const std::string& str);
+
  private:
   void EmitBeginDoc();
   void EmitEndDoc();
@@ -124,6 +134,12 @@ class YAML_CPP_API Emitter {
 
   void SpaceOrIndentTo(bool requireSpace, std::size_t indent);
 
+  void JsonBeginGroup(bool isSeq);
+  void JsonEndGroup(bool isSeq);
+  bool JsonPrepareNode();
+  void JsonWriteLiteral(const char* str, std::size_t size);
+  void JsonWriteString(const std::string& str, bool allowLiteral);
+
   const char* ComputeFullBoolName(bool b) const;
   const char* ComputeNullName() const;
   bool CanEmitNewline() const;
@@ -138,14 +154,10 @@ inline Emitter& Emitter::WriteIntegralType(T value) {
   if (!good())
     return *this;
 
-  PrepareNode(EmitterNodeType::Scalar);
-
   std::stringstream stream;
   PrepareIntegralStream(stream);
   stream << value;
-  m_stream << stream.str();
-
-  StartedScalar();
+  WriteNumber(stream.str(), true);
 
   return *this;
 }
@@ -155,8 +167,6 @@ inline Emitter& Emitter::WriteStreamable(T value) {
   if (!good())
     return *this;
 
-  PrepareNode(EmitterNodeType::Scalar);
-
   std::stringstream stream;
   SetStreamablePrecision<T>(stream);
 
@@ -180,9 +190,7 @@ inline Emitter& Emitter::WriteStreamable(T value) {
   if (!special) {
     stream << value;
   }
-  m_stream << stream.str();
-
-  StartedScalar();
+  WriteNumber(stream.str(), !special);
 
   return *this;
 }
@@ -66,7 +66,11 @@ enum EMITTER_MANIP {
   // Flow, // duplicate
   // Block, // duplicate
   // Auto, // duplicate
-  LongKey
+  LongKey,
+
+  // output format manipulators
+  // Auto, // duplicate (YAML)
+  CompactJson
 };
 
 struct _Indent {
@@ -0,0 +1,125 @@
+#ifndef EVENTCURSOR_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define EVENTCURSOR_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+#include "yaml-cpp/anchor.h"
+#include "yaml-cpp/dll.h"
+#include "yaml-cpp/emitterstyle.h"
+#include "yaml-cpp/mark.h"
+
+namespace YAML {
+class EventQueue;
+class Parser;
+class SingleDocParser;
+
+/**
+ * One parse event, as read from an {@link EventCursor}. These correspond to
+ * the calls made on an {@link EventHandler}.
+ */
+struct YAML_CPP_API Event {
+  struct Type {
+    enum value {
+      StreamEnd,
+      DocumentStart,
+      DocumentEnd,
+      Null,
+      Alias,
+      Scalar,
+      SequenceStart,
+      SequenceEnd,
+      MapStart,
+      MapEnd
+    };
+  };
+
+  Event();
+
+  Type::value type;
+
+  /** Where the event starts in the input; null for end events. */
+  Mark mark;
+
+  /** The tag of a scalar or collection. */
+  std::string tag;
+
+  /** The anchor of a node, or for an alias, the anchor it refers to. */
+  anchor_t anchor;
+
+  /** The value of a scalar. */
+  std::string value;
+
+  /** The style of a collection. */
+  EmitterStyle::value style;
+};
+
+/**
+ * Reads the events of a parser one at a time, rather than having them pushed
+ * into an {@link EventHandler} a document at a time. Only as much of the
+ * input is scanned as the events read so far need, so a caller can stop at
+ * any point without paying for the rest.
+ */
+class YAML_CPP_API EventCursor {
+ public:
+  /**
+   * Constructs a cursor over the given parser, which must outlive it. The
+   * parser must not be used directly while the cursor is in use.
+   */
+  explicit EventCursor(Parser& parser);
+
+  EventCursor(const EventCursor&) = delete;
+  EventCursor(EventCursor&&) = delete;
+  EventCursor& operator=(const EventCursor&) = delete;
+  EventCursor& operator=(EventCursor&&) = delete;
+
+  ~EventCursor();
+
+  /**
+   * Reads the next event. The returned reference stays valid until the next
+   * call to {@code next} or {@code skip}. Once the input is exhausted, this
+   * returns a {@link Event::Type::StreamEnd} event.
+   *
+   * @throw a ParserException on error.
+   */
+  const Event& next();
+
+  /**
+   * Skips past the rest of the collection or document that the last event
+   * read started, up to and including its end event. The skipped part of
+   * the input is still parsed (and so still checked for errors), but
+   * nothing is recorded for it. Does nothing after any other event.
+   *
+   * @throw a ParserException on error.
+   */
+  void skip();
+
+ private:
+  bool Fill();
+  void Pop();
+  void Update(const Event& event);
+
+ private:
+  Parser& m_parser;
+  std::unique_ptr<SingleDocParser> m_pDocument;
+  std::unique_ptr<EventQueue> m_pQueue;
+
+  // the last event read is left at the front of the queue until the next
+  // one is; only the ones made up here (the ends of skips) are kept aside
+  bool m_isQueued;
+  Event m_event;
+  Event::Type::value m_type;
+
+  // the number of collections open after the last event read
+  std::size_t m_depth;
+};
+}  // namespace YAML
+
+#endif  // EVENTCURSOR_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -66,6 +66,7 @@ const char* const CHAR_IN_BLOCK = "unexpected character in block scalar";
 const char* const AMBIGUOUS_ANCHOR =
     "cannot assign the same alias to multiple nodes";
 const char* const UNKNOWN_ANCHOR = "the referenced anchor is not defined: ";
+const char* const TOO_MANY_ANCHORS = "too many anchors in the document";
 
 const char* const INVALID_NODE =
     "invalid node; this may result from using a map iterator as a sequence "
@@ -86,7 +87,10 @@ const char* const SINGLE_QUOTED_CHAR =
 const char* const INVALID_ANCHOR = "invalid anchor";
 const char* const INVALID_ALIAS = "invalid alias";
 const char* const INVALID_TAG = "invalid tag";
+const char* const JSON_ALIAS = "aliases cannot be emitted as JSON";
+const char* const JSON_KEY = "JSON map keys must be scalars";
 const char* const BAD_FILE = "bad file";
+const char* const BAD_PATH = "bad node path";
 
 template <typename T>
 inline const std::string KEY_NOT_FOUND_WITH_KEY(
@@ -298,6 +302,15 @@ class YAML_CPP_API BadFile : public Exception {
   BadFile(const BadFile&) = default;
   ~BadFile() YAML_CPP_NOEXCEPT override;
 };
+
+class YAML_CPP_API BadPath : public Exception {
+ public:
+  explicit BadPath(const std::string& path)
+      : Exception(Mark::null_mark(),
+                  std::string(ErrorMsg::BAD_PATH) + ": " + path) {}
+  BadPath(const BadPath&) = default;
+  ~BadPath() YAML_CPP_NOEXCEPT override;
+};
 }  // namespace YAML
 
 #endif  // EXCEPTIONS_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -51,6 +51,17 @@ inline bool IsNegativeInfinity(const std::string& input) {
 inline bool IsNaN(const std::string& input) {
   return input == ".nan" || input == ".NaN" || input == ".NAN";
 }
+
+// scalar_decoder
+// . The built-in conversions that read nothing but a scalar's text, so that
+//   they can read text that isn't in a Node (see FrozenNode::as). For any
+//   other type, it's false, and decode doesn't apply.
+template <typename T>
+struct scalar_decoder : std::false_type {
+  static bool decode(const std::string& /* input */, T& /* rhs */) {
+    return false;
+  }
+};
 }
 
 // Node
@@ -65,6 +76,16 @@ struct convert<Node> {
 };
 
 // std::string
+namespace conversion {
+template <>
+struct scalar_decoder<std::string> : std::true_type {
+  static bool decode(const std::string& input, std::string& rhs) {
+    rhs = input;
+    return true;
+  }
+};
+}  // namespace conversion
+
 template <>
 struct convert<std::string> {
   static Node encode(const std::string& rhs) { return Node(rhs); }
@@ -72,8 +93,7 @@ struct convert<std::string> {
   static bool decode(const Node& node, std::string& rhs) {
     if (!node.IsScalar())
       return false;
-    rhs = node.Scalar();
-    return true;
+    return conversion::scalar_decoder<std::string>::decode(node.Scalar(), rhs);
   }
 };
 
@@ -166,21 +186,10 @@ ConvertStreamTo(std::stringstream& stream, T& rhs) {
 }
 
 #define YAML_DEFINE_CONVERT_STREAMABLE(type, negative_op)                  \
+  namespace conversion {                                                   \
   template <>                                                              \
-  struct convert<type> {                                                   \
-                                                                           \
-    static Node encode(const type& rhs) {                                  \
-      std::stringstream stream;                                            \
-      stream.precision(std::numeric_limits<type>::max_digits10);           \
-      conversion::inner_encode(rhs, stream);                               \
-      return Node(stream.str());                                           \
-    }                                                                      \
-                                                                           \
-    static bool decode(const Node& node, type& rhs) {                      \
-      if (node.Type() != NodeType::Scalar) {                               \
-        return false;                                                      \
-      }                                                                    \
-      const std::string& input = node.Scalar();                            \
+  struct scalar_decoder<type> : std::true_type {                           \
+    static bool decode(const std::string& input, type& rhs) {              \
       std::stringstream stream(input);                                     \
       stream.unsetf(std::ios::dec);                                        \
       if ((stream.peek() == '-') && std::is_unsigned<type>::value) {       \
@@ -208,6 +217,25 @@ ConvertStreamTo(std::stringstream& stream, T& rhs) {
                                                                            \
       return false;                                                        \
     }                                                                      \
+  };                                                                       \
+  }                                                                        \
+                                                                           \
+  template <>                                                              \
+  struct convert<type> {                                                   \
+                                                                           \
+    static Node encode(const type& rhs) {                                  \
+      std::stringstream stream;                                            \
+      stream.precision(std::numeric_limits<type>::max_digits10);           \
+      conversion::inner_encode(rhs, stream);                               \
+      return Node(stream.str());                                           \
+    }                                                                      \
+                                                                           \
+    static bool decode(const Node& node, type& rhs) {                      \
+      if (node.Type() != NodeType::Scalar) {                               \
+        return false;                                                      \
+      }                                                                    \
+      return conversion::scalar_decoder<type>::decode(node.Scalar(), rhs); \
+    }                                                                      \
   }
 
 #define YAML_DEFINE_CONVERT_STREAMABLE_SIGNED(type) \
@@ -238,6 +266,13 @@ YAML_DEFINE_CONVERT_STREAMABLE_SIGNED(long double);
 #undef YAML_DEFINE_CONVERT_STREAMABLE
 
 // bool
+namespace conversion {
+template <>
+struct scalar_decoder<bool> : std::true_type {
+  YAML_CPP_API static bool decode(const std::string& input, bool& rhs);
+};
+}  // namespace conversion
+
 template <>
 struct convert<bool> {
   static Node encode(bool rhs) { return rhs ? Node("true") : Node("false"); }
@@ -311,6 +346,11 @@ struct convert<std::vector<T, A>> {
     if (!node.IsSequence())
       return false;
 
+    // packed numbers may be copied out wholesale
+    const detail::packed_numbers* pPacked = detail::packed_access::packed(node);
+    if (pPacked && pPacked->copy_to(rhs))
+      return true;
+
     rhs.clear();
     for (const auto& element : node)
 #if defined(__GNUC__) && __GNUC__ < 4
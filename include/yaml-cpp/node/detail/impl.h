@@ -18,7 +18,8 @@ namespace detail {
 template <typename Key, typename Enable = void>
 struct get_idx {
   static node* get(const std::vector<node*>& /* sequence */,
-                   const Key& /* key */, shared_memory_holder /* pMemory */) {
+                   const Key& /* key */,
+                   const shared_memory_holder& /* pMemory */) {
     return nullptr;
   }
 };
@@ -28,16 +29,19 @@ struct get_idx<Key,
                typename std::enable_if<std::is_unsigned<Key>::value &&
                                        !std::is_same<Key, bool>::value>::type> {
   static node* get(const std::vector<node*>& sequence, const Key& key,
-                   shared_memory_holder /* pMemory */) {
+                   const shared_memory_holder& /* pMemory */) {
     return key < sequence.size() ? sequence[key] : nullptr;
   }
 
   static node* get(std::vector<node*>& sequence, const Key& key,
-                   shared_memory_holder pMemory) {
+                   const shared_memory_holder& pMemory) {
     if (key > sequence.size() || (key > 0 && !sequence[key - 1]->is_defined()))
       return nullptr;
-    if (key == sequence.size())
-      sequence.push_back(&pMemory->create_node());
+    if (key == sequence.size()) {
+      node& value = pMemory->create_node();
+      value.mark_attached();
+      sequence.push_back(&value);
+    }
     return sequence[key];
   }
 };
@@ -45,13 +49,13 @@ struct get_idx<Key,
 template <typename Key>
 struct get_idx<Key, typename std::enable_if<std::is_signed<Key>::value>::type> {
   static node* get(const std::vector<node*>& sequence, const Key& key,
-                   shared_memory_holder pMemory) {
+                   const shared_memory_holder& pMemory) {
     return key >= 0 ? get_idx<std::size_t>::get(
                           sequence, static_cast<std::size_t>(key), pMemory)
                     : nullptr;
   }
   static node* get(std::vector<node*>& sequence, const Key& key,
-                   shared_memory_holder pMemory) {
+                   const shared_memory_holder& pMemory) {
     return key >= 0 ? get_idx<std::size_t>::get(
                           sequence, static_cast<std::size_t>(key), pMemory)
                     : nullptr;
@@ -97,7 +101,7 @@ struct remove_idx<Key,
 };
 
 template <typename T>
-inline bool node::equals(const T& rhs, shared_memory_holder pMemory) {
+inline bool node::equals(const T& rhs, const shared_memory_holder& pMemory) {
   T lhs;
   if (convert<T>::decode(Node(*this, pMemory), lhs)) {
     return lhs == rhs;
@@ -105,51 +109,63 @@ inline bool node::equals(const T& rhs, shared_memory_holder pMemory) {
   return false;
 }
 
-inline bool node::equals(const char* rhs, shared_memory_holder pMemory) {
-  std::string lhs;
-  if (convert<std::string>::decode(Node(*this, std::move(pMemory)), lhs)) {
-    return lhs == rhs;
-  }
-  return false;
+// a string key is compared with the scalar directly, as decoding it would,
+// but without making a Node to decode
+inline bool node::equals(const std::string& rhs,
+                         const shared_memory_holder& /* pMemory */) {
+  return type() == NodeType::Scalar && scalar() == rhs;
+}
+
+inline bool node::equals(const char* rhs,
+                         const shared_memory_holder& /* pMemory */) {
+  return type() == NodeType::Scalar && scalar() == rhs;
 }
 
 // indexing
 template <typename Key>
 inline node* node_data::get(const Key& key,
-                            shared_memory_holder pMemory) const {
+                            const shared_memory_holder& pMemory) const {
   switch (m_type) {
     case NodeType::Map:
       break;
     case NodeType::Undefined:
     case NodeType::Null:
       return nullptr;
-    case NodeType::Sequence:
-      if (node* pNode = get_idx<Key>::get(m_sequence, key, pMemory))
+    case NodeType::Sequence: {
+      // a packed sequence has no nodes to find; Node reads its elements
+      const node_seq& sequence = m_pSequence->nodes;
+      if (node* pNode = get_idx<Key>::get(sequence, key, pMemory))
         return pNode;
       return nullptr;
+    }
     case NodeType::Scalar:
       throw BadSubscript(m_mark, key);
   }
 
-  auto it = std::find_if(m_map.begin(), m_map.end(), [&](const kv_pair m) {
+  const node_map& pairs = m_pMap->pairs;
+  auto it = std::find_if(pairs.begin(), pairs.end(), [&](const kv_pair m) {
     return m.first->equals(key, pMemory);
   });
 
-  return it != m_map.end() ? it->second : nullptr;
+  return it != pairs.end() ? it->second : nullptr;
 }
 
 template <typename Key>
-inline node& node_data::get(const Key& key, shared_memory_holder pMemory) {
+inline node& node_data::get(const Key& key,
+                            const shared_memory_holder& pMemory) {
   switch (m_type) {
     case NodeType::Map:
       break;
     case NodeType::Undefined:
     case NodeType::Null:
     case NodeType::Sequence:
-      if (node* pNode = get_idx<Key>::get(m_sequence, key, pMemory)) {
-        m_type = NodeType::Sequence;
+      // an empty node is taken as an empty sequence, which the key may
+      // append to
+      if (m_type != NodeType::Sequence)
+        set_payload(NodeType::Sequence);
+      unpack(pMemory);
+      if (node* pNode = get_idx<Key>::get(m_pSequence->nodes, key, pMemory))
         return *pNode;
-      }
 
       convert_to_map(pMemory);
       break;
@@ -157,11 +173,12 @@ inline node& node_data::get(const Key& key, shared_memory_holder pMemory) {
       throw BadSubscript(m_mark, key);
   }
 
-  auto it = std::find_if(m_map.begin(), m_map.end(), [&](const kv_pair m) {
+  node_map& pairs = m_pMap->pairs;
+  auto it = std::find_if(pairs.begin(), pairs.end(), [&](const kv_pair m) {
     return m.first->equals(key, pMemory);
   });
 
-  if (it != m_map.end()) {
+  if (it != pairs.end()) {
     return *it->second;
   }
 
@@ -172,27 +189,32 @@ inline node& node_data::get(const Key& key, shared_memory_holder pMemory) {
 }
 
 template <typename Key>
-inline bool node_data::remove(const Key& key, shared_memory_holder pMemory) {
+inline bool node_data::remove(const Key& key,
+                              const shared_memory_holder& pMemory) {
   if (m_type == NodeType::Sequence) {
-    return remove_idx<Key>::remove(m_sequence, key, m_seqSize);
+    unpack(pMemory);
+    return remove_idx<Key>::remove(m_pSequence->nodes, key,
+                                   m_pSequence->size);
   }
 
   if (m_type == NodeType::Map) {
-    kv_pairs::iterator it = m_undefinedPairs.begin();
-    while (it != m_undefinedPairs.end()) {
+    kv_pairs& undefinedPairs = m_pMap->undefinedPairs;
+    kv_pairs::iterator it = undefinedPairs.begin();
+    while (it != undefinedPairs.end()) {
       kv_pairs::iterator jt = std::next(it);
       if (it->first->equals(key, pMemory)) {
-        m_undefinedPairs.erase(it);
+        undefinedPairs.erase(it);
       }
       it = jt;
     }
 
-    auto iter = std::find_if(m_map.begin(), m_map.end(), [&](const kv_pair m) {
+    node_map& pairs = m_pMap->pairs;
+    auto iter = std::find_if(pairs.begin(), pairs.end(), [&](const kv_pair m) {
       return m.first->equals(key, pMemory);
     });
 
-    if (iter != m_map.end()) {
-      m_map.erase(iter);
+    if (iter != pairs.end()) {
+      pairs.erase(iter);
       return true;
     }
   }
@@ -203,7 +225,7 @@ inline bool node_data::remove(const Key& key, shared_memory_holder pMemory) {
 // map
 template <typename Key, typename Value>
 inline void node_data::force_insert(const Key& key, const Value& value,
-                                    shared_memory_holder pMemory) {
+                                    const shared_memory_holder& pMemory) {
   switch (m_type) {
     case NodeType::Map:
       break;
@@ -223,7 +245,7 @@ inline void node_data::force_insert(const Key& key, const Value& value,
 
 template <typename T>
 inline node& node_data::convert_to_node(const T& rhs,
-                                        shared_memory_holder pMemory) {
+                                        const shared_memory_holder& pMemory) {
   Node value = convert<T>::encode(rhs);
   value.EnsureNodeExists();
   pMemory->merge(*value.m_pMemory);
@@ -13,6 +13,7 @@
 #include "yaml-cpp/node/ptr.h"
 #include <cstddef>
 #include <iterator>
+#include <utility>
 
 
 namespace YAML {
@@ -44,18 +45,39 @@ class iterator_base {
   using reference = V;
 
  public:
-  iterator_base() : m_iterator(), m_pMemory() {}
+  iterator_base()
+      : m_iterator(), m_pMemory(), m_pPackedSequence(nullptr), m_index(0) {}
   explicit iterator_base(base_type rhs, shared_memory_holder pMemory)
-      : m_iterator(rhs), m_pMemory(pMemory) {}
+      : m_iterator(rhs),
+        m_pMemory(std::move(pMemory)),
+        m_pPackedSequence(nullptr),
+        m_index(0) {}
+  // the element at index of a packed sequence, which pMemory keeps alive
+  iterator_base(const node& packedSequence, std::size_t index,
+                shared_memory_holder pMemory)
+      : m_iterator(),
+        m_pMemory(std::move(pMemory)),
+        m_pPackedSequence(&packedSequence),
+        m_index(index) {}
+  iterator_base(const iterator_base&) = default;
+  iterator_base(iterator_base&&) = default;
+  iterator_base& operator=(const iterator_base&) = default;
+  iterator_base& operator=(iterator_base&&) = default;
 
   template <class W>
   iterator_base(const iterator_base<W>& rhs,
                 typename std::enable_if<std::is_convertible<W*, V*>::value,
                                         enabler>::type = enabler())
-      : m_iterator(rhs.m_iterator), m_pMemory(rhs.m_pMemory) {}
+      : m_iterator(rhs.m_iterator),
+        m_pMemory(rhs.m_pMemory),
+        m_pPackedSequence(rhs.m_pPackedSequence),
+        m_index(rhs.m_index) {}
 
   iterator_base<V>& operator++() {
-    ++m_iterator;
+    if (m_pPackedSequence)
+      ++m_index;
+    else
+      ++m_iterator;
     return *this;
   }
 
@@ -67,15 +89,20 @@ class iterator_base {
 
   template <typename W>
   bool operator==(const iterator_base<W>& rhs) const {
+    if (m_pPackedSequence || rhs.m_pPackedSequence)
+      return m_pPackedSequence == rhs.m_pPackedSequence &&
+             m_index == rhs.m_index;
     return m_iterator == rhs.m_iterator;
   }
 
   template <typename W>
   bool operator!=(const iterator_base<W>& rhs) const {
-    return m_iterator != rhs.m_iterator;
+    return !(*this == rhs);
   }
 
   value_type operator*() const {
+    if (m_pPackedSequence)
+      return value_type(packed_access::element(*m_pPackedSequence, m_index));
     const typename base_type::value_type& v = *m_iterator;
     if (v.pNode)
       return value_type(Node(*v, m_pMemory));
@@ -89,6 +116,10 @@ class iterator_base {
  private:
   base_type m_iterator;
   shared_memory_holder m_pMemory;
+
+  // a packed sequence's elements are made as they're read
+  const node* m_pPackedSequence;
+  std::size_t m_index;
 };
 }  // namespace detail
 }  // namespace YAML
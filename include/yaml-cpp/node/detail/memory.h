@@ -7,7 +7,9 @@
 #pragma once
 #endif
 
+#include <cstddef>
 #include <set>
+#include <string>
 
 #include "yaml-cpp/dll.h"
 #include "yaml-cpp/node/ptr.h"
@@ -22,24 +24,53 @@ namespace YAML {
 namespace detail {
 class YAML_CPP_API memory {
  public:
-  memory() : m_nodes{} {}
+  memory() : m_nodes{}, m_collectedSize(0) {}
   node& create_node();
   void merge(const memory& rhs);
 
+  // collect
+  // . Frees the nodes that can't be reached from a node some Node handle
+  //   refers to (see node::has_handles), and moves the rest to fresh
+  //   storage. Returns how many were freed.
+  std::size_t collect();
+  std::size_t size() const { return m_nodes.size(); }
+  // how many nodes were left when last collected
+  std::size_t collected_size() const { return m_collectedSize; }
+
  private:
   using Nodes = std::set<shared_node>;
   Nodes m_nodes;
+  std::size_t m_collectedSize;
 };
 
 class YAML_CPP_API memory_holder {
  public:
-  memory_holder() : m_pMemory(new memory) {}
+  memory_holder() : m_pMemory(new memory), m_invalidKey{} {}
+  // for a node that doesn't exist, which has no memory, only the key it was
+  // looked up by
+  explicit memory_holder(const std::string& invalidKey)
+      : m_pMemory{}, m_invalidKey(invalidKey) {}
+
+  // invalid
+  // . Returns a holder for a node that doesn't exist. Without a key, it's
+  //   one that's shared (and not reference counted), so it's free to copy.
+  static const shared_memory_holder& invalid();
+  static shared_memory_holder invalid(const std::string& key);
 
   node& create_node() { return m_pMemory->create_node(); }
   void merge(memory_holder& rhs);
 
+  // collect
+  // . Collects the memory's garbage, but only once it's grown by more than
+  //   the given fraction since it was last collected (if growth is
+  //   positive). Returns how many nodes were freed.
+  std::size_t collect(double growth);
+
+  const std::string& invalid_key() const { return m_invalidKey; }
+
  private:
   shared_memory m_pMemory;
+  std::string m_invalidKey;
 };
 }  // namespace detail
 }  // namespace YAML
@@ -12,24 +12,28 @@
 #include "yaml-cpp/node/detail/node_ref.h"
 #include "yaml-cpp/node/ptr.h"
 #include "yaml-cpp/node/type.h"
-#include <set>
+#include <algorithm>
 #include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
 
 namespace YAML {
 namespace detail {
 class node {
- private:
-  struct less {
-    bool operator ()(const node* l, const node* r) const {return l->m_index < r->m_index;}
-  };
-
  public:
-  node() : m_pRef(new node_ref), m_dependencies{}, m_index{} {}
+  node()
+      : m_ref{},
+        m_pSharedRef{},
+        m_pRef(&m_ref),
+        m_dependencies{},
+        m_isAttached(false),
+        m_handles(0) {}
   node(const node&) = delete;
   node& operator=(const node&) = delete;
 
   bool is(const node& rhs) const { return m_pRef == rhs.m_pRef; }
-  const node_ref* ref() const { return m_pRef.get(); }
+  const node_ref* ref() const { return m_pRef; }
 
   bool is_defined() const { return m_pRef->is_defined(); }
   const Mark& mark() const { return m_pRef->mark(); }
@@ -38,34 +42,86 @@ class node {
   const std::string& scalar() const { return m_pRef->scalar(); }
   const std::string& tag() const { return m_pRef->tag(); }
   EmitterStyle::value style() const { return m_pRef->style(); }
+  template <typename T>
+  bool get_cached(T& value) const {
+    return m_pRef->get_cached(value);
+  }
+  template <typename T>
+  void set_cached(const T& value) const {
+    m_pRef->set_cached(value);
+  }
+
+  // sharing
+  // . a node_ref that may be reachable along more than one path (it was the
+  //   target of set_ref, or its node was placed in a collection twice) is
+  //   flagged as shared; unflagged refs can only be reached once from an
+  //   unattached root
+  bool is_shared() const { return m_pRef->is_shared(); }
+  bool is_attached() const { return m_isAttached; }
+  void mark_attached() {
+    if (m_isAttached)
+      m_pRef->mark_shared();
+    m_isAttached = true;
+  }
+
+  // handles
+  // . How many Node handles refer to this node. Nodes that some handle
+  //   refers to, and the nodes reachable from them, are the ones kept when
+  //   garbage is collected. Handles may be copied on several threads at once
+  //   while reading, so the count is atomic, but it orders nothing.
+  void add_handle() const { m_handles.fetch_add(1, std::memory_order_relaxed); }
+  void remove_handle() const {
+    m_handles.fetch_sub(1, std::memory_order_relaxed);
+  }
+  bool has_handles() const {
+    return m_handles.load(std::memory_order_relaxed) != 0;
+  }
 
   template <typename T>
-  bool equals(const T& rhs, shared_memory_holder pMemory);
-  bool equals(const char* rhs, shared_memory_holder pMemory);
+  bool equals(const T& rhs, const shared_memory_holder& pMemory);
+  bool equals(const std::string& rhs, const shared_memory_holder& pMemory);
+  bool equals(const char* rhs, const shared_memory_holder& pMemory);
 
   void mark_defined() {
     if (is_defined())
       return;
 
     m_pRef->mark_defined();
-    for (node* dependency : m_dependencies)
+    nodes dependencies;
+    dependencies.swap(m_dependencies);
+    for (node* dependency : dependencies)
       dependency->mark_defined();
-    m_dependencies.clear();
   }
 
+  // add_dependency
+  // . rhs is defined along with this node. An undefined node rarely has more
+  //   than a parent or two waiting on it, so they're just kept in a list.
   void add_dependency(node& rhs) {
     if (is_defined())
       rhs.mark_defined();
-    else
-      m_dependencies.insert(&rhs);
+    else if (std::find(m_dependencies.begin(), m_dependencies.end(), &rhs) ==
+             m_dependencies.end())
+      m_dependencies.push_back(&rhs);
   }
 
-  void set_ref(const node& rhs) {
+  // remove_dependencies_if
+  // . For garbage collection, to forget the nodes that were collected.
+  template <typename Predicate>
+  void remove_dependencies_if(Predicate isCollected) {
+    m_dependencies.erase(std::remove_if(m_dependencies.begin(),
+                                        m_dependencies.end(), isCollected),
+                         m_dependencies.end());
+  }
+
+  void set_ref(node& rhs) {
     if (rhs.is_defined())
       mark_defined();
-    m_pRef = rhs.m_pRef;
+    m_pSharedRef = rhs.share_ref();
+    m_pRef = m_pSharedRef.get();
+    m_ref.reset();
+    m_pRef->mark_shared();
   }
-  void set_data(const node& rhs) {
+  void set_data(node& rhs) {
     if (rhs.is_defined())
       mark_defined();
     m_pRef->set_data(*rhs.m_pRef);
@@ -90,6 +146,10 @@ class node {
     mark_defined();
     m_pRef->set_tag(tag);
   }
+  void set_tag(const shared_tag& pTag) {
+    mark_defined();
+    m_pRef->set_tag(pTag);
+  }
 
   // style
   void set_style(EmitterStyle::value style) {
@@ -97,6 +157,22 @@ class node {
     m_pRef->set_style(style);
   }
 
+  // packed sequence
+  const packed_numbers* packed() const { return m_pRef->packed(); }
+  bool append_packed(const std::string& text) {
+    return m_pRef->append_packed(text);
+  }
+  void unpack(const shared_memory_holder& pMemory) {
+    m_pRef->unpack(pMemory);
+  }
+
+  // garbage collection
+  bool has_payload() const { return m_pRef->has_payload(); }
+  void prune() { m_pRef->prune(); }
+  void list_children(std::vector<node*>& children) const {
+    m_pRef->list_children(children);
+  }
+
   // size/iterator
   std::size_t size() const { return m_pRef->size(); }
 
@@ -111,12 +187,11 @@ class node {
   node_iterator end() { return m_pRef->end(); }
 
   // sequence
-  void push_back(node& input, shared_memory_holder pMemory) {
+  void push_back(node& input, const shared_memory_holder& pMemory) {
     m_pRef->push_back(input, pMemory);
     input.add_dependency(*this);
-    m_index = m_amount.fetch_add(1);
   }
-  void insert(node& key, node& value, shared_memory_holder pMemory) {
+  void insert(node& key, node& value, const shared_memory_holder& pMemory) {
     m_pRef->insert(key, value, pMemory);
     key.add_dependency(*this);
     value.add_dependency(*this);
@@ -124,52 +199,67 @@ class node {
 
   // indexing
   template <typename Key>
-  node* get(const Key& key, shared_memory_holder pMemory) const {
+  node* get(const Key& key, const shared_memory_holder& pMemory) const {
     // NOTE: this returns a non-const node so that the top-level Node can wrap
     // it, and returns a pointer so that it can be nullptr (if there is no such
     // key).
     return static_cast<const node_ref&>(*m_pRef).get(key, pMemory);
   }
   template <typename Key>
-  node& get(const Key& key, shared_memory_holder pMemory) {
+  node& get(const Key& key, const shared_memory_holder& pMemory) {
     node& value = m_pRef->get(key, pMemory);
     value.add_dependency(*this);
     return value;
   }
   template <typename Key>
-  bool remove(const Key& key, shared_memory_holder pMemory) {
+  bool remove(const Key& key, const shared_memory_holder& pMemory) {
     return m_pRef->remove(key, pMemory);
   }
 
-  node* get(node& key, shared_memory_holder pMemory) const {
+  node* get(node& key, const shared_memory_holder& pMemory) const {
     // NOTE: this returns a non-const node so that the top-level Node can wrap
     // it, and returns a pointer so that it can be nullptr (if there is no such
     // key).
     return static_cast<const node_ref&>(*m_pRef).get(key, pMemory);
   }
-  node& get(node& key, shared_memory_holder pMemory) {
+  node& get(node& key, const shared_memory_holder& pMemory) {
     node& value = m_pRef->get(key, pMemory);
     key.add_dependency(*this);
     value.add_dependency(*this);
     return value;
   }
-  bool remove(node& key, shared_memory_holder pMemory) {
+  bool remove(node& key, const shared_memory_holder& pMemory) {
     return m_pRef->remove(key, pMemory);
   }
 
   // map
   template <typename Key, typename Value>
   void force_insert(const Key& key, const Value& value,
-                    shared_memory_holder pMemory) {
+                    const shared_memory_holder& pMemory) {
     m_pRef->force_insert(key, value, pMemory);
   }
 
  private:
-  shared_node_ref m_pRef;
-  using nodes = std::set<node*, less>;
+  // share_ref
+  // . The ref is kept inline until another node is made to refer to it (by
+  //   set_ref), when it's moved out to the heap for them both to point to.
+  const shared_node_ref& share_ref() {
+    if (!m_pSharedRef) {
+      m_pSharedRef = std::make_shared<node_ref>();
+      m_pSharedRef->take(m_ref);
+      m_pRef = m_pSharedRef.get();
+    }
+    return m_pSharedRef;
+  }
+
+ private:
+  node_ref m_ref;  // unless it's been shared
+  shared_node_ref m_pSharedRef;
+  node_ref* m_pRef;
+  using nodes = std::vector<node*>;
   nodes m_dependencies;
-  size_t m_index;
-  static YAML_CPP_API std::atomic<size_t> m_amount;
+  bool m_isAttached;
+  mutable std::atomic<std::uint32_t> m_handles;
 };
 }  // namespace detail
 }  // namespace YAML
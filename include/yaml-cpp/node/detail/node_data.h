@@ -7,14 +7,20 @@
 #pragma once
 #endif
 
+#include <atomic>
+#include <cstdint>
+#include <cstring>
 #include <list>
 #include <map>
+#include <memory>
 #include <string>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
 #include "yaml-cpp/dll.h"
 #include "yaml-cpp/node/detail/node_iterator.h"
+#include "yaml-cpp/node/detail/packed.h"
 #include "yaml-cpp/node/iterator.h"
 #include "yaml-cpp/node/ptr.h"
 #include "yaml-cpp/node/type.h"
@@ -27,16 +33,55 @@ class node;
 
 namespace YAML {
 namespace detail {
+// scalar_cache_kind
+// . Which of the types a scalar's decoded value can be cached as T is, or 0
+//   if it's none of them: the built-in arithmetic types, that fit the cache.
+template <typename T>
+struct scalar_cache_kind : std::integral_constant<std::uint8_t, 0> {};
+#define YAML_CPP_SCALAR_CACHE_KIND(type, kind) \
+  template <>                                  \
+  struct scalar_cache_kind<type> : std::integral_constant<std::uint8_t, kind> {}
+
+YAML_CPP_SCALAR_CACHE_KIND(bool, 1);
+YAML_CPP_SCALAR_CACHE_KIND(char, 2);
+YAML_CPP_SCALAR_CACHE_KIND(signed char, 3);
+YAML_CPP_SCALAR_CACHE_KIND(unsigned char, 4);
+YAML_CPP_SCALAR_CACHE_KIND(short, 5);
+YAML_CPP_SCALAR_CACHE_KIND(unsigned short, 6);
+YAML_CPP_SCALAR_CACHE_KIND(int, 7);
+YAML_CPP_SCALAR_CACHE_KIND(unsigned, 8);
+YAML_CPP_SCALAR_CACHE_KIND(long, 9);
+YAML_CPP_SCALAR_CACHE_KIND(unsigned long, 10);
+YAML_CPP_SCALAR_CACHE_KIND(long long, 11);
+YAML_CPP_SCALAR_CACHE_KIND(unsigned long long, 12);
+YAML_CPP_SCALAR_CACHE_KIND(float, 13);
+YAML_CPP_SCALAR_CACHE_KIND(double, 14);
+
+#undef YAML_CPP_SCALAR_CACHE_KIND
+
+// node_data
+// . Only the payload for the node's type is kept: a scalar holds its string
+//   inline, and a sequence or map points to its nodes, which are kept out of
+//   line (along with the bookkeeping only they need).
 class YAML_CPP_API node_data {
  public:
   node_data();
   node_data(const node_data&) = delete;
   node_data& operator=(const node_data&) = delete;
+  ~node_data();
+
+  // reset
+  // . Returns the data to how a new node's is.
+  void reset();
+  // take
+  // . Moves rhs's data here, leaving rhs reset.
+  void take(node_data& rhs);
 
   void mark_defined();
   void set_mark(const Mark& mark);
   void set_type(NodeType::value type);
   void set_tag(const std::string& tag);
+  void set_tag(const shared_tag& pTag);
   void set_null();
   void set_scalar(const std::string& scalar);
   void set_style(EmitterStyle::value style);
@@ -46,10 +91,30 @@ class YAML_CPP_API node_data {
   NodeType::value type() const {
     return m_isDefined ? m_type : NodeType::Undefined;
   }
-  const std::string& scalar() const { return m_scalar; }
-  const std::string& tag() const { return m_tag; }
+  const std::string& scalar() const {
+    return m_type == NodeType::Scalar ? m_scalar : empty_scalar();
+  }
+  const std::string& tag() const {
+    return m_pTag ? *m_pTag : empty_scalar();
+  }
   EmitterStyle::value style() const { return m_style; }
 
+  // scalar cache
+  // . A scalar keeps the first value it's successfully decoded to, if that's
+  //   of a type scalar_cache_kind knows, until it's changed. The cache is
+  //   filled only once, so reading it (or trying to fill it) is safe from
+  //   several threads at once, as long as nothing changes the node then.
+  template <typename T>
+  bool get_cached(T& value) const {
+    return get_cached(value, std::integral_constant<
+                                 bool, scalar_cache_kind<T>::value != 0>());
+  }
+  template <typename T>
+  void set_cached(const T& value) const {
+    set_cached(value, std::integral_constant<
+                          bool, scalar_cache_kind<T>::value != 0>());
+  }
+
   // size/iterator
   std::size_t size() const;
 
@@ -59,17 +124,48 @@ class YAML_CPP_API node_data {
   const_node_iterator end() const;
   node_iterator end();
 
+  // packed sequence
+  // . A sequence of plain numbers may keep them packed (see packed_numbers)
+  //   rather than as nodes, until something needs the nodes: anything that
+  //   reaches its elements through a non-const node unpacks it first. Const
+  //   reads are given a node made for the element alone (see
+  //   packed_access), so they never write to the sequence.
+  const packed_numbers* packed() const {
+    return m_type == NodeType::Sequence ? m_pSequence->pPacked.get()
+                                        : nullptr;
+  }
+  // append_packed
+  // . Appends the text to the packed numbers of a sequence that has no
+  //   nodes. Returns false if it isn't a number, or this isn't such a
+  //   sequence.
+  bool append_packed(const std::string& text);
+  void unpack(const shared_memory_holder& pMemory);
+
+  // garbage collection
+  // . prune drops the map entries that were only ever looked up: an
+  //   undefined value that no handle refers to, that isn't shared, and that
+  //   no lookup into it has made a map (or sequence) of, with its key.
+  //   Nothing else can reach them, and looking the key up again makes one
+  //   just like it. has_payload is whether the data holds a scalar,
+  //   sequence or map, even if it isn't defined yet.
+  //   list_children appends the nodes the data refers to.
+  bool has_payload() const {
+    return m_type != NodeType::Undefined && m_type != NodeType::Null;
+  }
+  void prune();
+  void list_children(std::vector<node*>& children) const;
+
   // sequence
   void push_back(node& node, const shared_memory_holder& pMemory);
   void insert(node& key, node& value, const shared_memory_holder& pMemory);
 
   // indexing
   template <typename Key>
-  node* get(const Key& key, shared_memory_holder pMemory) const;
+  node* get(const Key& key, const shared_memory_holder& pMemory) const;
   template <typename Key>
-  node& get(const Key& key, shared_memory_holder pMemory);
+  node& get(const Key& key, const shared_memory_holder& pMemory);
   template <typename Key>
-  bool remove(const Key& key, shared_memory_holder pMemory);
+  bool remove(const Key& key, const shared_memory_holder& pMemory);
 
   node* get(node& key, const shared_memory_holder& pMemory) const;
   node& get(node& key, const shared_memory_holder& pMemory);
@@ -78,7 +174,7 @@ class YAML_CPP_API node_data {
   // map
   template <typename Key, typename Value>
   void force_insert(const Key& key, const Value& value,
-                    shared_memory_holder pMemory);
+                    const shared_memory_holder& pMemory);
 
  public:
   static const std::string& empty_scalar();
@@ -87,39 +183,84 @@ class YAML_CPP_API node_data {
   void compute_seq_size() const;
   void compute_map_size() const;
 
-  void reset_sequence();
-  void reset_map();
+  void set_payload(NodeType::value type);
+  void destroy_payload();
 
   void insert_map_pair(node& key, node& value);
+  void add_map_pair(node& key, node& value);
   void convert_to_map(const shared_memory_holder& pMemory);
   void convert_sequence_to_map(const shared_memory_holder& pMemory);
 
   template <typename T>
-  static node& convert_to_node(const T& rhs, shared_memory_holder pMemory);
+  static node& convert_to_node(const T& rhs,
+                               const shared_memory_holder& pMemory);
+
+  template <typename T>
+  bool get_cached(T& value, std::true_type) const {
+    if (m_cacheKind.load(std::memory_order_acquire) !=
+        scalar_cache_kind<T>::value)
+      return false;
+    std::memcpy(&value, &m_cache, sizeof(T));
+    return true;
+  }
+  template <typename T>
+  bool get_cached(T&, std::false_type) const {
+    return false;
+  }
+  template <typename T>
+  void set_cached(const T& value, std::true_type) const {
+    // the first thread to claim the cache fills it; it's published only
+    // once the value's written
+    std::uint8_t empty = 0;
+    if (m_type != NodeType::Scalar ||
+        !m_cacheKind.compare_exchange_strong(empty, cache_busy(),
+                                             std::memory_order_acquire))
+      return;
+    std::memcpy(&m_cache, &value, sizeof(T));
+    m_cacheKind.store(scalar_cache_kind<T>::value, std::memory_order_release);
+  }
+  template <typename T>
+  void set_cached(const T&, std::false_type) const {}
+  static std::uint8_t cache_busy() { return 0xff; }
+  void clear_cache() { m_cacheKind.store(0, std::memory_order_relaxed); }
 
  private:
-  bool m_isDefined;
-  Mark m_mark;
-  NodeType::value m_type;
-  std::string m_tag;
-  EmitterStyle::value m_style;
+  using node_seq = std::vector<node *>;
+  using node_map = std::vector<std::pair<node*, node*>>;
+  using kv_pair = std::pair<node*, node*>;
+  using kv_pairs = std::list<kv_pair>;
 
-  // scalar
-  std::string m_scalar;
+  struct sequence_data {
+    sequence_data() : nodes{}, size(0), pPacked{} {}
 
-  // sequence
-  using node_seq = std::vector<node *>;
-  node_seq m_sequence;
+    node_seq nodes;
+    std::size_t size;  // how many nodes, from the front, are defined
+    std::unique_ptr<packed_numbers> pPacked;  // only while there are no nodes
+  };
 
-  mutable std::size_t m_seqSize;
+  struct map_data {
+    map_data() : pairs{}, undefinedPairs{} {}
 
-  // map
-  using node_map = std::vector<std::pair<node*, node*>>;
-  node_map m_map;
+    node_map pairs;
+    kv_pairs undefinedPairs;
+  };
 
-  using kv_pair = std::pair<node*, node*>;
-  using kv_pairs = std::list<kv_pair>;
-  mutable kv_pairs m_undefinedPairs;
+  Mark m_mark;
+  bool m_isDefined;
+  NodeType::value m_type : 8;
+  EmitterStyle::value m_style : 8;
+  // which type m_cache holds (see scalar_cache_kind), 0 if none, or
+  // cache_busy() while a thread is filling it
+  mutable std::atomic<std::uint8_t> m_cacheKind;
+  mutable std::uint64_t m_cache;
+  shared_tag m_pTag;  // shared between the nodes with the same tag
+
+  // the payload, which m_type says which of
+  union {
+    std::string m_scalar;
+    sequence_data* m_pSequence;
+    map_data* m_pMap;
+  };
 };
 }
 }
@@ -7,6 +7,9 @@
 #pragma once
 #endif
 
+#include <memory>
+#include <utility>
+
 #include "yaml-cpp/dll.h"
 #include "yaml-cpp/node/type.h"
 #include "yaml-cpp/node/ptr.h"
@@ -14,9 +17,13 @@
 
 namespace YAML {
 namespace detail {
+// node_ref
+// . Holds its data inline, until the data is shared with another ref (by
+//   set_data), when it's moved out to the heap for them both to point to.
 class node_ref {
  public:
-  node_ref() : m_pData(new node_data) {}
+  node_ref()
+      : m_data{}, m_pSharedData{}, m_pData(&m_data), m_isShared(false) {}
   node_ref(const node_ref&) = delete;
   node_ref& operator=(const node_ref&) = delete;
 
@@ -26,17 +33,67 @@ class node_ref {
   const std::string& scalar() const { return m_pData->scalar(); }
   const std::string& tag() const { return m_pData->tag(); }
   EmitterStyle::value style() const { return m_pData->style(); }
+  template <typename T>
+  bool get_cached(T& value) const {
+    return m_pData->get_cached(value);
+  }
+  template <typename T>
+  void set_cached(const T& value) const {
+    m_pData->set_cached(value);
+  }
+  bool is_shared() const { return m_isShared; }
 
   void mark_defined() { m_pData->mark_defined(); }
-  void set_data(const node_ref& rhs) { m_pData = rhs.m_pData; }
+  void mark_shared() { m_isShared = true; }
+  void set_data(node_ref& rhs) {
+    m_pSharedData = rhs.share_data();
+    m_pData = m_pSharedData.get();
+    m_data.reset();
+  }
+
+  // reset
+  // . Returns the ref to how a new node's is.
+  void reset() {
+    m_data.reset();
+    m_pSharedData.reset();
+    m_pData = &m_data;
+    m_isShared = false;
+  }
+  // take
+  // . Moves rhs's data (or its share of someone else's) here, leaving rhs
+  //   reset.
+  void take(node_ref& rhs) {
+    m_data.take(rhs.m_data);
+    m_pSharedData = std::move(rhs.m_pSharedData);
+    m_pData = m_pSharedData ? m_pSharedData.get() : &m_data;
+    m_isShared = rhs.m_isShared;
+    rhs.reset();
+  }
 
   void set_mark(const Mark& mark) { m_pData->set_mark(mark); }
   void set_type(NodeType::value type) { m_pData->set_type(type); }
   void set_tag(const std::string& tag) { m_pData->set_tag(tag); }
+  void set_tag(const shared_tag& pTag) { m_pData->set_tag(pTag); }
   void set_null() { m_pData->set_null(); }
   void set_scalar(const std::string& scalar) { m_pData->set_scalar(scalar); }
   void set_style(EmitterStyle::value style) { m_pData->set_style(style); }
 
+  // packed sequence
+  const packed_numbers* packed() const { return m_pData->packed(); }
+  bool append_packed(const std::string& text) {
+    return m_pData->append_packed(text);
+  }
+  void unpack(const shared_memory_holder& pMemory) {
+    m_pData->unpack(pMemory);
+  }
+
+  // garbage collection
+  bool has_payload() const { return m_pData->has_payload(); }
+  void prune() { m_pData->prune(); }
+  void list_children(std::vector<node*>& children) const {
+    m_pData->list_children(children);
+  }
+
   // size/iterator
   std::size_t size() const { return m_pData->size(); }
 
@@ -51,46 +108,59 @@ class node_ref {
   node_iterator end() { return m_pData->end(); }
 
   // sequence
-  void push_back(node& node, shared_memory_holder pMemory) {
+  void push_back(node& node, const shared_memory_holder& pMemory) {
     m_pData->push_back(node, pMemory);
   }
-  void insert(node& key, node& value, shared_memory_holder pMemory) {
+  void insert(node& key, node& value, const shared_memory_holder& pMemory) {
     m_pData->insert(key, value, pMemory);
   }
 
   // indexing
   template <typename Key>
-  node* get(const Key& key, shared_memory_holder pMemory) const {
+  node* get(const Key& key, const shared_memory_holder& pMemory) const {
     return static_cast<const node_data&>(*m_pData).get(key, pMemory);
   }
   template <typename Key>
-  node& get(const Key& key, shared_memory_holder pMemory) {
+  node& get(const Key& key, const shared_memory_holder& pMemory) {
     return m_pData->get(key, pMemory);
   }
   template <typename Key>
-  bool remove(const Key& key, shared_memory_holder pMemory) {
+  bool remove(const Key& key, const shared_memory_holder& pMemory) {
     return m_pData->remove(key, pMemory);
   }
 
-  node* get(node& key, shared_memory_holder pMemory) const {
+  node* get(node& key, const shared_memory_holder& pMemory) const {
     return static_cast<const node_data&>(*m_pData).get(key, pMemory);
   }
-  node& get(node& key, shared_memory_holder pMemory) {
+  node& get(node& key, const shared_memory_holder& pMemory) {
     return m_pData->get(key, pMemory);
   }
-  bool remove(node& key, shared_memory_holder pMemory) {
+  bool remove(node& key, const shared_memory_holder& pMemory) {
     return m_pData->remove(key, pMemory);
   }
 
   // map
   template <typename Key, typename Value>
   void force_insert(const Key& key, const Value& value,
-                    shared_memory_holder pMemory) {
+                    const shared_memory_holder& pMemory) {
     m_pData->force_insert(key, value, pMemory);
   }
 
  private:
-  shared_node_data m_pData;
+  const shared_node_data& share_data() {
+    if (!m_pSharedData) {
+      m_pSharedData = std::make_shared<node_data>();
+      m_pSharedData->take(m_data);
+      m_pData = m_pSharedData.get();
+    }
+    return m_pSharedData;
+  }
+
+ private:
+  node_data m_data;  // unless it's been shared
+  shared_node_data m_pSharedData;
+  node_data* m_pData;
+  bool m_isShared;
 };
 }
 }
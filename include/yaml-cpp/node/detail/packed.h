@@ -0,0 +1,146 @@
+#ifndef VALUE_DETAIL_PACKED_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define VALUE_DETAIL_PACKED_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "yaml-cpp/dll.h"
+
+namespace YAML {
+namespace detail {
+// packed_numbers
+// . The elements of a sequence of plain numbers, kept as an array of values
+//   instead of as nodes. While every element is an integer in canonical
+//   decimal form, only the integers are kept, since that's their text; once
+//   one isn't, every element is kept as a double, along with its text.
+class YAML_CPP_API packed_numbers {
+ public:
+  packed_numbers();
+
+  // append
+  // . Returns false, leaving the array as it was, if the text isn't a plain
+  //   number (or one that converts exactly as the array would hold it).
+  bool append(const std::string& text);
+
+  std::size_t size() const {
+    return m_isIntegral ? m_integers.size() : m_reals.size();
+  }
+  std::string text(std::size_t index) const;
+
+  // copy_to
+  // . Copies the values straight out, when converting each element's text
+  //   would give just the value kept: integers to any number type, and
+  //   doubles only to double. Returns false otherwise, or if a value is out
+  //   of range, so that the elements are converted one by one instead.
+  template <typename T, typename A>
+  bool copy_to(std::vector<T, A>& values) const {
+    if (m_isIntegral)
+      return copy_integers(values, is_number<T>());
+    return copy_reals(values, std::is_same<T, double>());
+  }
+
+ private:
+  // the types converted from text as numbers (char, for one, isn't)
+  template <typename T>
+  struct is_number
+      : std::integral_constant<
+            bool, std::is_arithmetic<T>::value &&
+                      !std::is_same<T, bool>::value &&
+                      !std::is_same<T, char>::value &&
+                      !std::is_same<T, wchar_t>::value &&
+                      !std::is_same<T, char16_t>::value &&
+                      !std::is_same<T, char32_t>::value> {};
+
+  template <typename T, typename A>
+  bool copy_integers(std::vector<T, A>& values, std::true_type) const {
+    for (std::int64_t value : m_integers) {
+      if (!fits<T>(value, std::is_floating_point<T>(), std::is_signed<T>()))
+        return false;
+    }
+    values.assign(m_integers.begin(), m_integers.end());
+    return true;
+  }
+  template <typename T, typename A>
+  bool copy_integers(std::vector<T, A>&, std::false_type) const {
+    return false;
+  }
+
+  template <typename T, typename A>
+  bool copy_reals(std::vector<T, A>& values, std::true_type) const {
+    values.assign(m_reals.begin(), m_reals.end());
+    return true;
+  }
+  template <typename T, typename A>
+  bool copy_reals(std::vector<T, A>&, std::false_type) const {
+    return false;
+  }
+
+  template <typename T, typename Signed>
+  static bool fits(std::int64_t, std::true_type, Signed) {
+    return true;
+  }
+  template <typename T>
+  static bool fits(std::int64_t value, std::false_type, std::true_type) {
+    return value >= (std::numeric_limits<T>::min)() &&
+           value <= (std::numeric_limits<T>::max)();
+  }
+  template <typename T>
+  static bool fits(std::int64_t value, std::false_type, std::false_type) {
+    return value >= 0 && static_cast<std::uint64_t>(value) <=
+                             (std::numeric_limits<T>::max)();
+  }
+
+  void convert_to_reals();
+
+  bool m_isIntegral;
+  std::vector<std::int64_t> m_integers;
+  std::vector<double> m_reals;
+  std::string m_text;  // the reals' text, back to back
+  std::vector<std::uint32_t> m_textEnds;
+};
+
+// packed_idx
+// . The position a key names in a packed sequence of the given size, for
+//   the keys that index a sequence.
+template <typename Key, typename Enable = void>
+struct packed_idx {
+  static bool get(const Key& /* key */, std::size_t /* size */,
+                  std::size_t& /* index */) {
+    return false;
+  }
+};
+
+template <typename Key>
+struct packed_idx<
+    Key, typename std::enable_if<std::is_unsigned<Key>::value &&
+                                 !std::is_same<Key, bool>::value>::type> {
+  static bool get(const Key& key, std::size_t size, std::size_t& index) {
+    if (key >= size)
+      return false;
+    index = static_cast<std::size_t>(key);
+    return true;
+  }
+};
+
+template <typename Key>
+struct packed_idx<Key,
+                  typename std::enable_if<std::is_signed<Key>::value>::type> {
+  static bool get(const Key& key, std::size_t size, std::size_t& index) {
+    return key >= 0 && packed_idx<std::size_t>::get(
+                           static_cast<std::size_t>(key), size, index);
+  }
+};
+}  // namespace detail
+}  // namespace YAML
+
+#endif  // VALUE_DETAIL_PACKED_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -0,0 +1,107 @@
+#ifndef VALUE_DOCUMENTSTREAM_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define VALUE_DOCUMENTSTREAM_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <iosfwd>
+#include <iterator>
+#include <memory>
+
+#include "yaml-cpp/dll.h"
+#include "yaml-cpp/node/node.h"
+
+namespace YAML {
+class Parser;
+
+/**
+ * Loads the YAML documents in an input stream one at a time, as they are
+ * iterated over, rather than all at once like {@link LoadAll}:
+ *
+ * <pre>
+ * for (const YAML::Node& document : YAML::DocumentStream(input)) { ... }
+ * </pre>
+ *
+ * Only the current document is held, so each one is freed as soon as the
+ * caller lets go of it.
+ */
+class YAML_CPP_API DocumentStream {
+ public:
+  /** An input iterator over the documents; advancing it loads the next. */
+  class iterator {
+   public:
+    using iterator_category = std::input_iterator_tag;
+    using value_type = Node;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const Node*;
+    using reference = const Node&;
+
+    iterator() : m_pStream(nullptr) {}
+
+    reference operator*() const { return m_pStream->m_document; }
+    pointer operator->() const { return &m_pStream->m_document; }
+
+    iterator& operator++() {
+      if (!m_pStream->Next())
+        m_pStream = nullptr;
+      return *this;
+    }
+
+    bool operator==(const iterator& rhs) const {
+      return m_pStream == rhs.m_pStream;
+    }
+    bool operator!=(const iterator& rhs) const { return !(*this == rhs); }
+
+   private:
+    friend class DocumentStream;
+    explicit iterator(DocumentStream* pStream) : m_pStream(pStream) {}
+
+    DocumentStream* m_pStream;
+  };
+
+  /**
+   * Constructs a stream over the given input, which must live as long as
+   * the stream. Nothing is read until the first document is asked for.
+   */
+  explicit DocumentStream(std::istream& input);
+
+  DocumentStream(const DocumentStream&) = delete;
+  DocumentStream(DocumentStream&&) = delete;
+  DocumentStream& operator=(const DocumentStream&) = delete;
+  DocumentStream& operator=(DocumentStream&&) = delete;
+
+  ~DocumentStream();
+
+  /**
+   * Loads the next document, which {@link current} then returns.
+   *
+   * @throws {@link ParserException} if it is malformed.
+   * @return false if there are no more documents
+   */
+  bool Next();
+
+  /** The document last loaded by {@link Next}, or null if there is none. */
+  const Node& current() const { return m_document; }
+
+  /**
+   * Loads the first document if none has been loaded yet, and returns an
+   * iterator at the current document.
+   *
+   * @throws {@link ParserException} if it is malformed.
+   */
+  iterator begin();
+  iterator end() { return iterator(); }
+
+ private:
+  std::unique_ptr<Parser> m_pParser;
+  Node m_document;
+  bool m_isStarted;
+  bool m_isDone;
+};
+}  // namespace YAML
+
+#endif  // VALUE_DOCUMENTSTREAM_H_62B23520_7C8E_11DE_8A39_0800200C9A66
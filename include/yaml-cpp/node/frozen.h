@@ -0,0 +1,284 @@
+#ifndef VALUE_FROZEN_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define VALUE_FROZEN_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "yaml-cpp/dll.h"
+#include "yaml-cpp/emitterstyle.h"
+#include "yaml-cpp/exceptions.h"
+#include "yaml-cpp/mark.h"
+#include "yaml-cpp/node/convert.h"
+#include "yaml-cpp/node/node.h"
+#include "yaml-cpp/node/type.h"
+
+namespace YAML {
+class FrozenDocument;
+class FrozenNode;
+namespace detail {
+struct frozen_data;
+}  // namespace detail
+
+/**
+ * Copies a document into an immutable {@link FrozenDocument}. The node may
+ * be changed or dropped afterwards; the copy is unaffected.
+ */
+YAML_CPP_API FrozenDocument Freeze(const Node& node);
+
+/**
+ * A read-only view of one node of a {@link FrozenDocument}: a pointer to
+ * the document's nodes and an index into them, so views are cheap to copy,
+ * and they stay valid when the document is moved. Reading through one never
+ * writes anything. Nor does it allocate, except in {@code as} (see there).
+ *
+ * Looking up a missing key, or an index past the end, gives a view that
+ * isn't defined, as it does for a const {@link Node}.
+ */
+class YAML_CPP_API FrozenNode {
+ public:
+  class const_iterator;
+  using iterator = const_iterator;
+
+  FrozenNode() : m_pData(nullptr), m_index(0) {}
+
+  NodeType::value Type() const;
+  bool IsDefined() const { return Type() != NodeType::Undefined; }
+  bool IsNull() const { return Type() == NodeType::Null; }
+  bool IsScalar() const { return Type() == NodeType::Scalar; }
+  bool IsSequence() const { return Type() == NodeType::Sequence; }
+  bool IsMap() const { return Type() == NodeType::Map; }
+
+  // bool conversions
+  explicit operator bool() const { return IsDefined(); }
+  bool operator!() const { return !IsDefined(); }
+
+  // access
+  // . A scalar read as a string, a number or a bool is decoded straight
+  //   from the document's text, by the same code convert uses. Anything
+  //   else converts through a Node made by Thaw, so anything that converts
+  //   from a Node converts from here, but at the cost of copying the node.
+  template <typename T>
+  T as() const;
+  template <typename T, typename S>
+  T as(const S& fallback) const;
+  const std::string& Scalar() const;
+  const std::string& Tag() const;
+  EmitterStyle::value Style() const;
+
+  /**
+   * Copies this node, and everything under it, back into a new {@link
+   * Node}. Nodes that were aliased in the original are aliased in the copy.
+   */
+  Node Thaw() const;
+
+  // whether both view the same node of the same document
+  bool is(const FrozenNode& rhs) const {
+    return m_pData == rhs.m_pData && m_index == rhs.m_index;
+  }
+
+  // size/iterator
+  std::size_t size() const;
+  const_iterator begin() const;
+  const_iterator end() const;
+
+  // indexing
+  // . A map is looked up by scalar key, by binary search; a sequence by
+  //   position.
+  FrozenNode operator[](const std::string& key) const;
+  FrozenNode operator[](const char* key) const;
+  FrozenNode operator[](std::size_t index) const;
+  FrozenNode operator[](int index) const {
+    return index < 0 ? FrozenNode() : (*this)[std::size_t(index)];
+  }
+
+ private:
+  friend class FrozenDocument;
+  class Thawer;
+
+  FrozenNode(const detail::frozen_data* pData, std::uint32_t index)
+      : m_pData(pData), m_index(index) {}
+
+  const detail::frozen_data* m_pData;
+  std::uint32_t m_index;
+};
+
+/**
+ * What a {@link FrozenNode} iterator points at: the element, for a
+ * sequence, or the key and value (as first and second), for a map.
+ */
+struct FrozenIteratorValue : public FrozenNode,
+                             public std::pair<FrozenNode, FrozenNode> {
+  FrozenIteratorValue() : FrozenNode(), std::pair<FrozenNode, FrozenNode>() {}
+  explicit FrozenIteratorValue(const FrozenNode& node)
+      : FrozenNode(node), std::pair<FrozenNode, FrozenNode>() {}
+  FrozenIteratorValue(const FrozenNode& key, const FrozenNode& value)
+      : FrozenNode(), std::pair<FrozenNode, FrozenNode>(key, value) {}
+};
+
+class YAML_CPP_API FrozenNode::const_iterator {
+ public:
+  using iterator_category = std::input_iterator_tag;
+  using value_type = FrozenIteratorValue;
+  using difference_type = std::ptrdiff_t;
+  using pointer = void;
+  using reference = FrozenIteratorValue;
+
+  const_iterator() : m_pData(nullptr), m_pChild(nullptr), m_isMap(false) {}
+
+  FrozenIteratorValue operator*() const {
+    if (m_isMap)
+      return FrozenIteratorValue(FrozenNode(m_pData, m_pChild[0]),
+                                 FrozenNode(m_pData, m_pChild[1]));
+    return FrozenIteratorValue(FrozenNode(m_pData, m_pChild[0]));
+  }
+
+  const_iterator& operator++() {
+    m_pChild += m_isMap ? 2 : 1;
+    return *this;
+  }
+  const_iterator operator++(int) {
+    const_iterator it = *this;
+    ++*this;
+    return it;
+  }
+
+  bool operator==(const const_iterator& rhs) const {
+    return m_pChild == rhs.m_pChild;
+  }
+  bool operator!=(const const_iterator& rhs) const { return !(*this == rhs); }
+
+ private:
+  friend class FrozenNode;
+
+  const_iterator(const detail::frozen_data* pData, const std::uint32_t* pChild,
+                 bool isMap)
+      : m_pData(pData), m_pChild(pChild), m_isMap(isMap) {}
+
+  const detail::frozen_data* m_pData;
+  const std::uint32_t* m_pChild;
+  bool m_isMap;
+};
+
+namespace detail {
+// frozen_data
+// . The nodes of a FrozenDocument, which it keeps on the heap, so that the
+//   views into them stay put when the document is moved.
+// . Every node is an entry. For a scalar, value indexes its text in
+//   strings; for a collection, it's where its children start in children.
+//   A sequence's children are its elements, and a map's are its keys and
+//   values, interleaved, followed by the index of each pair sorted by key.
+struct YAML_CPP_API frozen_data {
+  struct Entry {
+    std::uint8_t type;
+    std::uint8_t style;
+    bool isShared;  // reached from more than one place
+    std::uint32_t tag;
+    std::uint32_t value;
+    std::uint32_t size;
+  };
+
+  frozen_data() : entries{}, children{}, strings{} {}
+
+  const Entry* entry(std::uint32_t index) const {
+    return index < entries.size() ? &entries[index] : nullptr;
+  }
+
+  std::uint32_t Find(const Entry& map, const char* key,
+                     std::size_t length) const;
+
+  std::vector<Entry> entries;
+  std::vector<std::uint32_t> children;
+  std::vector<std::string> strings;  // every scalar and tag, once each
+};
+}  // namespace detail
+
+/**
+ * An immutable copy of a document, made by {@link Freeze}, that any number
+ * of threads may read at once without locking:
+ *
+ * <pre>
+ * const YAML::FrozenDocument config = YAML::Freeze(YAML::LoadFile(path));
+ * // ... then, on any thread:
+ * int port = config.root()["server"]["port"].as<int>();
+ * </pre>
+ *
+ * Every node is an entry in one array, and the children of a collection are
+ * a run of indices into it, so the whole document is a handful of
+ * allocations. Each map also keeps its pairs sorted by key, so looking a key
+ * up is a binary search rather than a scan. A node aliased in several places
+ * is stored once.
+ *
+ * Views into the document ({@link FrozenNode}) hold a plain pointer to its
+ * nodes, which moving the document takes along; they must not outlive the
+ * document they were last moved to.
+ */
+class YAML_CPP_API FrozenDocument {
+ public:
+  FrozenDocument();
+  FrozenDocument(const FrozenDocument&) = delete;
+  FrozenDocument(FrozenDocument&&) = default;
+  FrozenDocument& operator=(const FrozenDocument&) = delete;
+  FrozenDocument& operator=(FrozenDocument&&) = default;
+  ~FrozenDocument();
+
+  /**
+   * The root of the document, which isn't defined if the document is (or
+   * if it was moved from).
+   */
+  FrozenNode root() const { return FrozenNode(m_pData.get(), 0); }
+
+  /** The number of distinct nodes in the document. */
+  std::size_t NodeCount() const {
+    return m_pData ? m_pData->entries.size() : 0;
+  }
+
+ private:
+  friend YAML_CPP_API FrozenDocument Freeze(const Node& node);
+
+  std::unique_ptr<detail::frozen_data> m_pData;
+};
+
+inline NodeType::value FrozenNode::Type() const {
+  const detail::frozen_data::Entry* pEntry =
+      m_pData ? m_pData->entry(m_index) : nullptr;
+  return pEntry ? static_cast<NodeType::value>(pEntry->type)
+                : NodeType::Undefined;
+}
+
+template <typename T>
+inline T FrozenNode::as() const {
+  if (!conversion::scalar_decoder<T>::value || !IsScalar())
+    return Thaw().as<T>();
+
+  T value;
+  if (!conversion::scalar_decoder<T>::decode(Scalar(), value))
+    throw TypedBadConversion<T>(Mark::null_mark());
+  return value;
+}
+
+template <typename T, typename S>
+inline T FrozenNode::as(const S& fallback) const {
+  if (!IsDefined())
+    return fallback;
+  if (!conversion::scalar_decoder<T>::value || !IsScalar())
+    return Thaw().as<T>(fallback);
+
+  T value;
+  if (!conversion::scalar_decoder<T>::decode(Scalar(), value))
+    return fallback;
+  return value;
+}
+}  // namespace YAML
+
+#endif  // VALUE_FROZEN_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -14,80 +14,116 @@
 #include "yaml-cpp/node/node.h"
 #include <sstream>
 #include <string>
+#include <utility>
 
 namespace YAML {
-inline Node::Node()
-    : m_isValid(true), m_invalidKey{}, m_pMemory(nullptr), m_pNode(nullptr) {}
+inline Node::Node() : m_pMemory(nullptr), m_pNode(nullptr) {}
 
 inline Node::Node(NodeType::value type)
-    : m_isValid(true),
-      m_invalidKey{},
-      m_pMemory(new detail::memory_holder),
+    : m_pMemory(new detail::memory_holder),
       m_pNode(&m_pMemory->create_node()) {
+  m_pNode->add_handle();
   m_pNode->set_type(type);
 }
 
 template <typename T>
 inline Node::Node(const T& rhs)
-    : m_isValid(true),
-      m_invalidKey{},
-      m_pMemory(new detail::memory_holder),
+    : m_pMemory(new detail::memory_holder),
       m_pNode(&m_pMemory->create_node()) {
+  m_pNode->add_handle();
   Assign(rhs);
 }
 
 inline Node::Node(const detail::iterator_value& rhs)
-    : m_isValid(rhs.m_isValid),
-      m_invalidKey(rhs.m_invalidKey),
-      m_pMemory(rhs.m_pMemory),
-      m_pNode(rhs.m_pNode) {}
+    : m_pMemory(rhs.m_pMemory), m_pNode(rhs.m_pNode) {
+  if (m_pNode)
+    m_pNode->add_handle();
+}
+
+inline Node::Node(const Node& rhs)
+    : m_pMemory(rhs.m_pMemory), m_pNode(rhs.m_pNode) {
+  if (m_pNode)
+    m_pNode->add_handle();
+}
 
-inline Node::Node(const Node&) = default;
+// the node moved from is left as a new one would be
+inline Node::Node(Node&& rhs) noexcept
+    : m_pMemory(std::move(rhs.m_pMemory)), m_pNode(rhs.m_pNode) {
+  rhs.m_pNode = nullptr;
+}
 
 inline Node::Node(Zombie)
-    : m_isValid(false), m_invalidKey{}, m_pMemory{}, m_pNode(nullptr) {}
+    : m_pMemory(detail::memory_holder::invalid()), m_pNode(nullptr) {}
 
 inline Node::Node(Zombie, const std::string& key)
-    : m_isValid(false), m_invalidKey(key), m_pMemory{}, m_pNode(nullptr) {}
+    : m_pMemory(detail::memory_holder::invalid(key)), m_pNode(nullptr) {}
 
 inline Node::Node(detail::node& node, detail::shared_memory_holder pMemory)
-    : m_isValid(true), m_invalidKey{}, m_pMemory(pMemory), m_pNode(&node) {}
+    : m_pMemory(std::move(pMemory)), m_pNode(&node) {
+  m_pNode->add_handle();
+}
 
-inline Node::~Node() = default;
+inline Node::~Node() {
+  if (m_pNode)
+    m_pNode->remove_handle();
+}
+
+// SetNode
+// . Refers the handle to another node, in the same memory (or one that
+//   merged it), keeping count of the handles that refer to each.
+inline void Node::SetNode(detail::node* pNode) const {
+  if (pNode)
+    pNode->add_handle();
+  if (m_pNode)
+    m_pNode->remove_handle();
+  m_pNode = pNode;
+}
+
+inline const std::string& Node::InvalidKey() const {
+  return IsValid() ? detail::node_data::empty_scalar()
+                   : m_pMemory->invalid_key();
+}
 
 inline void Node::EnsureNodeExists() const {
-  if (!m_isValid)
-    throw InvalidNode(m_invalidKey);
+  if (!IsValid())
+    throw InvalidNode(InvalidKey());
   if (!m_pNode) {
-    m_pMemory.reset(new detail::memory_holder);
-    m_pNode = &m_pMemory->create_node();
+    detail::shared_memory_holder pMemory(new detail::memory_holder);
+    SetNode(&pMemory->create_node());
+    m_pMemory = std::move(pMemory);
     m_pNode->set_null();
   }
 }
 
 inline bool Node::IsDefined() const {
-  if (!m_isValid) {
+  if (!IsValid()) {
     return false;
   }
   return m_pNode ? m_pNode->is_defined() : true;
 }
 
 inline Mark Node::Mark() const {
-  if (!m_isValid) {
-    throw InvalidNode(m_invalidKey);
+  if (!IsValid()) {
+    throw InvalidNode(InvalidKey());
   }
   return m_pNode ? m_pNode->mark() : Mark::null_mark();
 }
 
 inline NodeType::value Node::Type() const {
-  if (!m_isValid)
-    throw InvalidNode(m_invalidKey);
+  if (!IsValid())
+    throw InvalidNode(InvalidKey());
   return m_pNode ? m_pNode->type() : NodeType::Null;
 }
 
 // access
 
 // template helpers
+namespace detail {
+inline const packed_numbers* packed_access::packed(const Node& node) {
+  return node.m_pNode ? node.m_pNode->packed() : nullptr;
+}
+}  // namespace detail
+
 template <typename T, typename S>
 struct as_if {
   explicit as_if(const Node& node_) : node(node_) {}
@@ -98,8 +134,12 @@ struct as_if {
       return fallback;
 
     T t;
-    if (convert<T>::decode(node, t))
+    if (node.m_pNode->get_cached(t))
+      return t;
+    if (convert<T>::decode(node, t)) {
+      node.m_pNode->set_cached(t);
       return t;
+    }
     return fallback;
   }
 };
@@ -128,8 +168,12 @@ struct as_if<T, void> {
       throw TypedBadConversion<T>(node.Mark());
 
     T t;
-    if (convert<T>::decode(node, t))
+    if (node.m_pNode->get_cached(t))
       return t;
+    if (convert<T>::decode(node, t)) {
+      node.m_pNode->set_cached(t);
+      return t;
+    }
     throw TypedBadConversion<T>(node.Mark());
   }
 };
@@ -151,27 +195,27 @@ struct as_if<std::string, void> {
 // access functions
 template <typename T>
 inline T Node::as() const {
-  if (!m_isValid)
-    throw InvalidNode(m_invalidKey);
+  if (!IsValid())
+    throw InvalidNode(InvalidKey());
   return as_if<T, void>(*this)();
 }
 
 template <typename T, typename S>
 inline T Node::as(const S& fallback) const {
-  if (!m_isValid)
+  if (!IsValid())
     return fallback;
   return as_if<T, S>(*this)(fallback);
 }
 
 inline const std::string& Node::Scalar() const {
-  if (!m_isValid)
-    throw InvalidNode(m_invalidKey);
+  if (!IsValid())
+    throw InvalidNode(InvalidKey());
   return m_pNode ? m_pNode->scalar() : detail::node_data::empty_scalar();
 }
 
 inline const std::string& Node::Tag() const {
-  if (!m_isValid)
-    throw InvalidNode(m_invalidKey);
+  if (!IsValid())
+    throw InvalidNode(InvalidKey());
   return m_pNode ? m_pNode->tag() : detail::node_data::empty_scalar();
 }
 
@@ -181,8 +225,8 @@ inline void Node::SetTag(const std::string& tag) {
 }
 
 inline EmitterStyle::value Node::Style() const {
-  if (!m_isValid)
-    throw InvalidNode(m_invalidKey);
+  if (!IsValid())
+    throw InvalidNode(InvalidKey());
   return m_pNode ? m_pNode->style() : EmitterStyle::Default;
 }
 
@@ -193,8 +237,8 @@ inline void Node::SetStyle(EmitterStyle::value style) {
 
 // assignment
 inline bool Node::is(const Node& rhs) const {
-  if (!m_isValid || !rhs.m_isValid)
-    throw InvalidNode(m_invalidKey);
+  if (!IsValid() || !rhs.IsValid())
+    throw InvalidNode(InvalidKey());
   if (!m_pNode || !rhs.m_pNode)
     return false;
   return m_pNode->is(*rhs.m_pNode);
@@ -213,17 +257,34 @@ inline Node& Node::operator=(const Node& rhs) {
   return *this;
 }
 
+// this still refers this node to rhs's, as a copy does; but when there's no
+// node here yet, rhs's handle is just taken over
+inline Node& Node::operator=(Node&& rhs) {
+  if (is(rhs))
+    return *this;
+  if (IsValid() && !m_pNode) {
+    rhs.EnsureNodeExists();
+    m_pNode = rhs.m_pNode;
+    m_pMemory = std::move(rhs.m_pMemory);
+    rhs.m_pNode = nullptr;
+    return *this;
+  }
+  AssignNode(rhs);
+  return *this;
+}
+
 inline void Node::reset(const YAML::Node& rhs) {
-  if (!m_isValid || !rhs.m_isValid)
-    throw InvalidNode(m_invalidKey);
+  if (!IsValid() || !rhs.IsValid())
+    throw InvalidNode(InvalidKey());
+  // the node first, while its memory is still held
+  SetNode(rhs.m_pNode);
   m_pMemory = rhs.m_pMemory;
-  m_pNode = rhs.m_pNode;
 }
 
 template <typename T>
 inline void Node::Assign(const T& rhs) {
-  if (!m_isValid)
-    throw InvalidNode(m_invalidKey);
+  if (!IsValid())
+    throw InvalidNode(InvalidKey());
   AssignData(convert<T>::encode(rhs));
 }
 
@@ -252,58 +313,65 @@ inline void Node::AssignData(const Node& rhs) {
 }
 
 inline void Node::AssignNode(const Node& rhs) {
-  if (!m_isValid)
-    throw InvalidNode(m_invalidKey);
+  if (!IsValid())
+    throw InvalidNode(InvalidKey());
   rhs.EnsureNodeExists();
 
   if (!m_pNode) {
-    m_pNode = rhs.m_pNode;
+    SetNode(rhs.m_pNode);
     m_pMemory = rhs.m_pMemory;
     return;
   }
 
   m_pNode->set_ref(*rhs.m_pNode);
   m_pMemory->merge(*rhs.m_pMemory);
-  m_pNode = rhs.m_pNode;
+  SetNode(rhs.m_pNode);
 }
 
 // size/iterator
 inline std::size_t Node::size() const {
-  if (!m_isValid)
-    throw InvalidNode(m_invalidKey);
+  if (!IsValid())
+    throw InvalidNode(InvalidKey());
   return m_pNode ? m_pNode->size() : 0;
 }
 
+// a packed sequence is unpacked to iterate over, unless it's const, when
+// its elements are made one at a time as they're read
 inline const_iterator Node::begin() const {
-  if (!m_isValid)
+  if (!IsValid() || !m_pNode)
     return const_iterator();
-  return m_pNode ? const_iterator(m_pNode->begin(), m_pMemory)
-                 : const_iterator();
+  if (m_pNode->packed())
+    return const_iterator(*m_pNode, 0, m_pMemory);
+  return const_iterator(m_pNode->begin(), m_pMemory);
 }
 
 inline iterator Node::begin() {
-  if (!m_isValid)
+  if (!IsValid() || !m_pNode)
     return iterator();
-  return m_pNode ? iterator(m_pNode->begin(), m_pMemory) : iterator();
+  m_pNode->unpack(m_pMemory);
+  return iterator(m_pNode->begin(), m_pMemory);
 }
 
 inline const_iterator Node::end() const {
-  if (!m_isValid)
+  if (!IsValid() || !m_pNode)
     return const_iterator();
-  return m_pNode ? const_iterator(m_pNode->end(), m_pMemory) : const_iterator();
+  if (const detail::packed_numbers* pPacked = m_pNode->packed())
+    return const_iterator(*m_pNode, pPacked->size(), m_pMemory);
+  return const_iterator(m_pNode->end(), m_pMemory);
 }
 
 inline iterator Node::end() {
-  if (!m_isValid)
+  if (!IsValid() || !m_pNode)
     return iterator();
-  return m_pNode ? iterator(m_pNode->end(), m_pMemory) : iterator();
+  m_pNode->unpack(m_pMemory);
+  return iterator(m_pNode->end(), m_pMemory);
 }
 
 // sequence
 template <typename T>
 inline void Node::push_back(const T& rhs) {
-  if (!m_isValid)
-    throw InvalidNode(m_invalidKey);
+  if (!IsValid())
+    throw InvalidNode(InvalidKey());
   push_back(Node(rhs));
 }
 
@@ -324,6 +392,12 @@ std::string key_to_string(const Key& key) {
 template <typename Key>
 inline const Node Node::operator[](const Key& key) const {
   EnsureNodeExists();
+  if (const detail::packed_numbers* pPacked = m_pNode->packed()) {
+    std::size_t index = 0;
+    if (detail::packed_idx<Key>::get(key, pPacked->size(), index))
+      return detail::packed_access::element(*m_pNode, index);
+    return Node(ZombieNode, key_to_string(key));
+  }
   detail::node* value =
       static_cast<const detail::node&>(*m_pNode).get(key, m_pMemory);
   if (!value) {
@@ -0,0 +1,186 @@
+#ifndef VALUE_LAZY_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define VALUE_LAZY_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "yaml-cpp/dll.h"
+#include "yaml-cpp/mark.h"
+#include "yaml-cpp/node/iterator.h"
+#include "yaml-cpp/node/node.h"
+#include "yaml-cpp/node/type.h"
+
+namespace YAML {
+class LazyDocument;
+
+/**
+ * A node of a {@link LazyDocument}, which is only parsed once it's looked
+ * into. Indexing a block map found by the skim looks the key up without
+ * parsing anything; anything else (converting, iterating, indexing any
+ * other node) parses and builds the node, and everything under it, first.
+ *
+ * Looking up a missing key gives a node that isn't defined, as it does for
+ * a const {@link Node}.
+ */
+class YAML_CPP_API LazyNode {
+ public:
+  LazyNode() : m_pDocument(nullptr), m_slot(0), m_node() {}
+  LazyNode(const LazyNode&) = default;
+  LazyNode& operator=(const LazyNode&) = default;
+
+  NodeType::value Type() const;
+  bool IsDefined() const;
+  bool IsNull() const { return Type() == NodeType::Null; }
+  bool IsScalar() const { return Type() == NodeType::Scalar; }
+  bool IsSequence() const { return Type() == NodeType::Sequence; }
+  bool IsMap() const { return Type() == NodeType::Map; }
+
+  // bool conversions
+  explicit operator bool() const { return IsDefined(); }
+  bool operator!() const { return !IsDefined(); }
+
+  /**
+   * Parses and builds this node, if it hasn't been already, and returns it.
+   * The document keeps it, so later calls return the same node.
+   *
+   * @throws {@link ParserException} if it is malformed.
+   */
+  Node node() const;
+
+  // access
+  template <typename T>
+  T as() const {
+    return node().as<T>();
+  }
+  template <typename T, typename S>
+  T as(const S& fallback) const {
+    return node().as<T>(fallback);
+  }
+
+  // size/iterator
+  std::size_t size() const;
+  const_iterator begin() const { return node().begin(); }
+  const_iterator end() const { return node().end(); }
+
+  // indexing
+  LazyNode operator[](const std::string& key) const;
+  LazyNode operator[](const char* key) const {
+    return (*this)[std::string(key)];
+  }
+  LazyNode operator[](std::size_t index) const;
+  LazyNode operator[](int index) const;
+
+ private:
+  friend class LazyDocument;
+
+  LazyNode(LazyDocument* pDocument, std::size_t slot)
+      : m_pDocument(pDocument), m_slot(slot), m_node() {}
+  explicit LazyNode(const Node& node)
+      : m_pDocument(nullptr), m_slot(0), m_node(node) {}
+
+  // a node of the document's skim, or else an ordinary node
+  LazyDocument* m_pDocument;
+  std::size_t m_slot;
+  Node m_node;
+};
+
+/**
+ * Loads the first YAML document in a buffer (say, a mapped file) lazily,
+ * for callers that only read a few values out of a large document:
+ *
+ * <pre>
+ * YAML::LazyDocument document(data, size);
+ * int port = document.root()["server"]["port"].as<int>();
+ * </pre>
+ *
+ * Rather than being parsed up front, the buffer is skimmed line by line for
+ * the keys of its top-level block map, and the range of text each value
+ * spans; a value is parsed only when it's first used, and a block map
+ * inside one is skimmed the same way in turn. The nodes built are the same,
+ * marks included, as {@link Load} would build, but errors in a value are
+ * only thrown once it's parsed.
+ *
+ * The skim only understands plain and quoted keys. A document that isn't a
+ * block map, or whose structure it can't be sure of (aliases, directives,
+ * block scalars with explicit indentation), is parsed in full on first use
+ * instead, as is a value that isn't a block map of its own.
+ *
+ * The buffer must live as long as the document. The document isn't safe to
+ * use from several threads at once, since looking into it parses it.
+ */
+class YAML_CPP_API LazyDocument {
+ public:
+  LazyDocument(const char* input, std::size_t size);
+  explicit LazyDocument(const char* input);
+  explicit LazyDocument(const std::string& input);
+  explicit LazyDocument(std::string&&) = delete;
+
+  LazyDocument(const LazyDocument&) = delete;
+  LazyDocument(LazyDocument&&) = delete;
+  LazyDocument& operator=(const LazyDocument&) = delete;
+  LazyDocument& operator=(LazyDocument&&) = delete;
+
+  ~LazyDocument();
+
+  /** The root of the document; it's skimmed the first time it's used. */
+  LazyNode root() { return LazyNode(this, 0); }
+
+ private:
+  friend class LazyNode;
+
+  // Slot
+  // . A node found by the skim: the text of its value (and of its key, if
+  //   it's in a map), and, once it's been skimmed, either the range of the
+  //   slots of its entries or, if it isn't a block map, the node parsed.
+  struct Slot {
+    enum State { Unskimmed, Map, Parsed };
+
+    Slot(std::size_t begin_, const Mark& mark_, int indent_)
+        : begin(begin_),
+          end(0),
+          mark(mark_),
+          indent(indent_),
+          key(),
+          keyEnd(0),
+          keyMark(),
+          state(Unskimmed),
+          firstEntry(0),
+          entryCount(0),
+          keyNode(),
+          node(),
+          isBuilt(false) {}
+
+    std::size_t begin, end;
+    Mark mark;
+    int indent;  // of the line its key is on, or -1 for the root
+
+    std::string key;
+    std::size_t keyEnd;  // the key's text starts at keyMark
+    Mark keyMark;
+
+    State state;
+    std::size_t firstEntry, entryCount;
+    Node keyNode, node;  // the key's only once it's been parsed with it
+    bool isBuilt;
+  };
+
+  Slot& Skim(std::size_t slot);
+  bool SkimMap(std::size_t slot);
+  std::size_t Find(std::size_t slot, const std::string& key);
+  Node Build(std::size_t slot);
+  Node Parse(std::size_t begin, std::size_t end, const Mark& origin) const;
+
+  const char* m_input;
+  std::size_t m_size;
+  std::vector<Slot> m_slots;
+};
+}  // namespace YAML
+
+#endif  // VALUE_LAZY_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -7,6 +7,7 @@
 #pragma once
 #endif
 
+#include <cstddef>
 #include <stdexcept>
 #include <string>
 
@@ -21,7 +22,9 @@ namespace YAML {
 namespace detail {
 class node;
 class node_data;
+class packed_numbers;
 struct iterator_value;
+struct packed_access;
 }  // namespace detail
 }  // namespace YAML
 
@@ -29,14 +32,19 @@ namespace YAML {
 class YAML_CPP_API Node {
  public:
   friend class NodeBuilder;
+  friend class FrozenBuilder;
+  friend class LazyDocument;
   friend class NodeEvents;
   friend struct detail::iterator_value;
+  friend struct detail::packed_access;
   friend class detail::node;
   friend class detail::node_data;
   template <typename>
   friend class detail::iterator_base;
   template <typename T, typename S>
   friend struct as_if;
+  friend YAML_CPP_API std::size_t CollectGarbage(const Node& node,
+                                                double growth);
 
   using iterator = YAML::iterator;
   using const_iterator = YAML::const_iterator;
@@ -47,6 +55,7 @@ class YAML_CPP_API Node {
   explicit Node(const T& rhs);
   explicit Node(const detail::iterator_value& rhs);
   Node(const Node& rhs);
+  Node(Node&& rhs) noexcept;
   ~Node();
 
   YAML::Mark Mark() const;
@@ -81,6 +90,7 @@ class YAML_CPP_API Node {
   template <typename T>
   Node& operator=(const T& rhs);
   Node& operator=(const Node& rhs);
+  Node& operator=(Node&& rhs);
   void reset(const Node& rhs = Node());
 
   // size/iterator
@@ -119,6 +129,10 @@ class YAML_CPP_API Node {
   explicit Node(Zombie, const std::string&);
   explicit Node(detail::node& node, detail::shared_memory_holder pMemory);
 
+  // a node that doesn't exist (the result of looking up a missing key in a
+  // const node) has no node, but a memory holder that keeps the key
+  bool IsValid() const { return m_pNode || !m_pMemory; }
+  const std::string& InvalidKey() const;
   void EnsureNodeExists() const;
 
   template <typename T>
@@ -128,19 +142,50 @@ class YAML_CPP_API Node {
 
   void AssignData(const Node& rhs);
   void AssignNode(const Node& rhs);
+  void SetNode(detail::node* pNode) const;
 
  private:
-  bool m_isValid;
-  // String representation of invalid key, if the node is invalid.
-  std::string m_invalidKey;
   mutable detail::shared_memory_holder m_pMemory;
   mutable detail::node* m_pNode;
 };
 
+namespace detail {
+// packed_access
+// . Lets a conversion read a sequence's packed numbers, if it has them, and
+//   a const read make a node for one of its elements. Such a node is a
+//   plain scalar, with the sequence's mark, in memory of its own, so making
+//   one leaves the sequence as it was.
+struct YAML_CPP_API packed_access {
+  static const packed_numbers* packed(const Node& node);
+  static Node element(const node& sequence, std::size_t index);
+};
+}  // namespace detail
+
 YAML_CPP_API bool operator==(const Node& lhs, const Node& rhs);
 
 YAML_CPP_API Node Clone(const Node& node);
 
+/**
+ * Frees the nodes of the node's document that no {@link Node} can reach any
+ * more: those orphaned by {@code remove}, by reassigning a map's values, or
+ * by looking up missing keys of a non-const node without assigning them.
+ * Nodes are otherwise only freed with the whole document, so a long-lived
+ * document that's changed in place should call this now and then. Returns
+ * how many nodes were freed.
+ *
+ * Given a growth, nothing is collected until the document has grown by more
+ * than that fraction (say, 1.0 to double) since it was last collected, so
+ * that calling it after every change costs little in all.
+ *
+ * A missing key that was looked up, but not assigned, is forgotten by it, so
+ * assigning the key afterwards puts it at the end of its map rather than
+ * where it was looked up.
+ *
+ * Nothing else may use the document while it runs, and an iterator must not
+ * be kept across it unless a Node refers to the collection it iterates.
+ */
+YAML_CPP_API std::size_t CollectGarbage(const Node& node, double growth = 0);
+
 template <typename T>
 struct convert;
 }
@@ -7,6 +7,7 @@
 #pragma once
 #endif
 
+#include <cstddef>
 #include <iosfwd>
 #include <string>
 #include <vector>
@@ -37,6 +38,44 @@ YAML_CPP_API Node Load(const char* input);
  */
 YAML_CPP_API Node Load(std::istream& input);
 
+/**
+ * Loads the input stream as a single YAML document, like {@link
+ * Load(std::istream&)}, but with the input scanned on a second thread that
+ * runs ahead of building the nodes. This is only worth it for large
+ * documents.
+ *
+ * @throws {@link ParserException} if it is malformed.
+ */
+YAML_CPP_API Node LoadPipelined(std::istream& input);
+
+/**
+ * Loads the input string as a single YAML document, like {@link
+ * Load(std::istream&)}, but packs numeric sequences. See {@link
+ * LoadPacked(std::istream&)}.
+ *
+ * @throws {@link ParserException} if it is malformed.
+ */
+YAML_CPP_API Node LoadPacked(const std::string& input);
+
+/**
+ * Loads the input stream as a single YAML document, like {@link
+ * Load(std::istream&)}, but with each sequence whose elements are all plain
+ * (untagged, unquoted) numbers, like {@code [0.1, 0.2, 0.3]}, kept as a
+ * packed array of values rather than as a node per element. Converting one
+ * to a {@code std::vector} of numbers copies the values straight out, and
+ * emitting it writes each element's text as it was loaded.
+ *
+ * Otherwise it reads like any other sequence. Its elements have the
+ * sequence's mark rather than their own. Reading them through a const
+ * {@link Node} (iterating or indexing it) gives each element as a new scalar
+ * node, and leaves the sequence packed, so that several threads may read it
+ * at once, as they may any other document. The first time they're reached
+ * through a non-const one, it's unpacked into ordinary scalar nodes instead.
+ *
+ * @throws {@link ParserException} if it is malformed.
+ */
+YAML_CPP_API Node LoadPacked(std::istream& input);
+
 /**
  * Loads the input file as a single YAML document.
  *
@@ -45,6 +84,36 @@ YAML_CPP_API Node Load(std::istream& input);
  */
 YAML_CPP_API Node LoadFile(const std::string& filename);
 
+/**
+ * Loads only the parts of the first YAML document in the input string that
+ * the given paths select. See {@link LoadSelected(std::istream&, const
+ * std::vector<std::string>&)}.
+ *
+ * @throws {@link ParserException} if it is malformed.
+ * @throws {@link BadPath} if a path is malformed.
+ */
+YAML_CPP_API Node LoadSelected(const std::string& input,
+                               const std::vector<std::string>& paths);
+
+/**
+ * Loads only the parts of the first YAML document in the input stream that
+ * the given paths select, like {@code "spec.replicas"}, {@code
+ * "$.items[0].name"} or {@code "items[*].name"}. Keys are separated by
+ * {@code .}, sequence indices may be bracketed, {@code *} matches any key or
+ * index, and an empty path selects the whole document.
+ *
+ * The result keeps the selected nodes at the same place in the document:
+ * their ancestors are loaded too, with only the entries that lead to them.
+ * Sequence entries skipped before a selected one are loaded as nulls so that
+ * indices are preserved. Everything else is parsed but never built, and an
+ * alias to a node that was skipped loads as null.
+ *
+ * @throws {@link ParserException} if it is malformed.
+ * @throws {@link BadPath} if a path is malformed.
+ */
+YAML_CPP_API Node LoadSelected(std::istream& input,
+                               const std::vector<std::string>& paths);
+
 /**
  * Loads the input string as a list of YAML documents.
  *
@@ -66,6 +135,33 @@ YAML_CPP_API std::vector<Node> LoadAll(const char* input);
  */
 YAML_CPP_API std::vector<Node> LoadAll(std::istream& input);
 
+/**
+ * Loads the input string as a list of YAML documents, like {@link
+ * LoadAll(const std::string&)}, but parses them in parallel. See {@link
+ * LoadAllParallel(const char*, std::size_t, std::size_t)}.
+ *
+ * @throws {@link ParserException} if it is malformed.
+ */
+YAML_CPP_API std::vector<Node> LoadAllParallel(const std::string& input,
+                                               std::size_t threads = 0);
+
+/**
+ * Loads the {@code size} bytes at {@code input} (say, a mapped file) as a
+ * list of YAML documents, parsing runs of documents on up to {@code threads}
+ * threads at once (by default, one per hardware thread). The result, marks
+ * included, is the same as for {@link LoadAll}; if more than one document is
+ * malformed, the first error is thrown.
+ *
+ * The input is split at "---" and "..." lines, so it must be UTF-8; anything
+ * else, or input with a directive where it can't be told from part of a
+ * scalar, is loaded on one thread instead.
+ *
+ * @throws {@link ParserException} if it is malformed.
+ */
+YAML_CPP_API std::vector<Node> LoadAllParallel(const char* input,
+                                               std::size_t size,
+                                               std::size_t threads);
+
 /**
  * Loads the input file as a list of YAML documents.
  *
@@ -8,6 +8,7 @@
 #endif
 
 #include <memory>
+#include <string>
 
 namespace YAML {
 namespace detail {
@@ -22,6 +23,7 @@ using shared_node_ref = std::shared_ptr<node_ref>;
 using shared_node_data = std::shared_ptr<node_data>;
 using shared_memory_holder = std::shared_ptr<memory_holder>;
 using shared_memory = std::shared_ptr<memory>;
+using shared_tag = std::shared_ptr<const std::string>;
 }
 }
 
@@ -7,14 +7,18 @@
 #pragma once
 #endif
 
+#include <cstddef>
 #include <ios>
+#include <limits>
 #include <memory>
 
 #include "yaml-cpp/dll.h"
 
 namespace YAML {
+class EventCursor;
 class EventHandler;
 class Node;
+class NodeBuilder;
 class Scanner;
 struct Directives;
 struct Token;
@@ -50,6 +54,14 @@ class YAML_CPP_API Parser {
    */
   void Load(std::istream& in);
 
+  /**
+   * Resets the parser with the given input, held in memory, which must live
+   * as long as the parser. If the input is one document of plain JSON, it's
+   * read from an index of its structure, built up front, rather than one
+   * character at a time; the events are the same either way.
+   */
+  void Load(const char* input, std::size_t size);
+
   /**
    * Handles the next document by calling events on the {@code eventHandler}.
    *
@@ -58,9 +70,50 @@ class YAML_CPP_API Parser {
    */
   bool HandleNextDocument(EventHandler& eventHandler);
 
+  /**
+   * Sets how deeply collections may nest in a document before a {@link
+   * DeepRecursion} exception is thrown. Nesting is tracked on the heap rather
+   * than the call stack, so this only bounds the memory spent on it; the
+   * default is {@link DefaultMaxDepth}.
+   */
+  void SetMaxDepth(std::size_t maxDepth);
+
+  static const std::size_t DefaultMaxDepth = 10000;
+
+  /**
+   * Sets how many anchors a document may define (counting each time a name
+   * is reused) before a {@link ParserException} is thrown. By default, there
+   * is no limit.
+   */
+  void SetMaxAnchors(std::size_t maxAnchors);
+
+  static const std::size_t DefaultMaxAnchors =
+      std::numeric_limits<std::size_t>::max();
+
+  /**
+   * Scans the input on a second thread from now on (including any input
+   * loaded later), running ahead of the parsing and event handling on the
+   * caller's thread. Events and errors are the same as without it. The input
+   * stream mustn't be used elsewhere while the parser holds it.
+   */
+  void EnablePipelining();
+
   void PrintTokens(std::ostream& out);
 
  private:
+  friend class EventCursor;
+  friend class NodeBuilder;
+
+  /**
+   * Handles the next document like {@link HandleNextDocument}, but with the
+   * handler's event functions bound statically rather than called through
+   * the {@link EventHandler} vtable. It needs the scanner, so it's only
+   * instantiated for the library's own handlers; any other handler goes
+   * through {@link HandleNextDocument}.
+   */
+  template <typename Handler>
+  bool ParseNextDocument(Handler& handler);
+
   /**
    * Reads any directives that are next in the queue, setting the internal
    * {@code m_pDirectives} state.
@@ -81,10 +134,29 @@ class YAML_CPP_API Parser {
    */
   void HandleTagDirective(const Token& token);
 
+  /**
+   * Handles the input loaded with {@link Load(const char*, std::size_t)}
+   * as one document of plain JSON, through its structural index, if it is
+   * one. Returns false, having emitted nothing, if it isn't.
+   */
+  template <typename Handler>
+  bool ParseIndexedDocument(Handler& handler);
+
  private:
+  struct MemoryInput;
+
   std::unique_ptr<Scanner> m_pScanner;
   std::unique_ptr<Directives> m_pDirectives;
+  std::size_t m_maxDepth;
+  std::size_t m_maxAnchors;
+  bool m_isPipelined;
+
+  // the input loaded from memory, if it was, and whether nothing has been
+  // read from it yet, so that it might still be read through its index
+  std::unique_ptr<MemoryInput> m_pMemoryInput;
+  bool m_isIndexable;
 };
+
 }  // namespace YAML
 
 #endif  // PARSER_H_62B23520_7C8E_11DE_8A39_0800200C9A66
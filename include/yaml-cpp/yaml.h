@@ -8,6 +8,7 @@
 #endif
 
 #include "yaml-cpp/parser.h"
+#include "yaml-cpp/eventcursor.h"
 #include "yaml-cpp/emitter.h"
 #include "yaml-cpp/emitterstyle.h"
 #include "yaml-cpp/stlemitter.h"
@@ -19,6 +20,9 @@
 #include "yaml-cpp/node/iterator.h"
 #include "yaml-cpp/node/detail/impl.h"
 #include "yaml-cpp/node/parse.h"
+#include "yaml-cpp/node/documentstream.h"
+#include "yaml-cpp/node/frozen.h"
+#include "yaml-cpp/node/lazy.h"
 #include "yaml-cpp/node/emit.h"
 
 #endif  // YAML_H_62B23520_7C8E_11DE_8A39_0800200C9A66
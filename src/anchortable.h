@@ -0,0 +1,52 @@
+#ifndef ANCHORTABLE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define ANCHORTABLE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <string>
+#include <unordered_map>
+
+#include "yaml-cpp/anchor.h"
+
+namespace YAML {
+// The anchors defined so far in a document, hashed by name. Each name is
+// stored once, here, and stays put for as long as the table does, so events
+// can refer to it rather than copy it.
+class AnchorTable {
+ public:
+  AnchorTable() : m_anchors{}, m_curAnchor(0) {}
+
+  // Register
+  // . Defines the name as the next anchor (redefining it if it's been used
+  //   before), and returns that anchor, and the stored copy of the name.
+  anchor_t Register(const std::string& name, const std::string*& pName) {
+    auto it = m_anchors.find(name);
+    if (it == m_anchors.end())
+      it = m_anchors.emplace(name, NullAnchor).first;
+    pName = &it->first;
+    return it->second = ++m_curAnchor;
+  }
+
+  // Lookup
+  // . Returns the anchor the name was last defined as, or NullAnchor if it
+  //   hasn't been.
+  anchor_t Lookup(const std::string& name) const {
+    auto it = m_anchors.find(name);
+    return it == m_anchors.end() ? NullAnchor : it->second;
+  }
+
+  // the number of anchors defined, counting redefinitions
+  std::size_t AnchorCount() const { return m_curAnchor; }
+
+ private:
+  std::unordered_map<std::string, anchor_t> m_anchors;
+  anchor_t m_curAnchor;
+};
+}  // namespace YAML
+
+#endif  // ANCHORTABLE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
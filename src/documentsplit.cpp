@@ -0,0 +1,127 @@
+#include "documentsplit.h"
+
+#include <algorithm>
+#include <cstring>
+
+namespace YAML {
+namespace {
+struct Chunk {
+  std::size_t begin;
+  int line;
+  bool hasDirectives;
+  std::size_t directivesBegin;
+  std::size_t directivesEnd;
+};
+}  // namespace
+
+bool IsBlankOrBreak(char ch) {
+  return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r';
+}
+
+// IsDocumentIndicator
+// . Returns true if the line is a document start ("---") or end ("...")
+//   marker, by the same rule as Exp::DocStart and Exp::DocEnd.
+bool IsDocumentIndicator(const char* line, const char* end, char ch) {
+  return end - line >= 3 && line[0] == ch && line[1] == ch && line[2] == ch &&
+         (end - line == 3 || IsBlankOrBreak(line[3]));
+}
+
+// IsEmptyLine
+// . Returns true if the line has nothing but whitespace or a comment.
+bool IsEmptyLine(const char* line, const char* end) {
+  while (line != end && (*line == ' ' || *line == '\t'))
+    line++;
+  return line == end || *line == '\n' || *line == '\r' || *line == '#';
+}
+
+// SplitDocuments
+// . The scanner ends whatever it is in the middle of (block and quoted
+//   scalars included, even if only to throw) at a "---" or "..." in the
+//   first column, so those lines are the only document boundaries, and only
+//   need finding line by line.
+// . A document ends at a "---" once it has some content, or at the first
+//   line with any after a run of "..."; the scanner folds a run of those
+//   into the document before.
+bool SplitDocuments(const char* data, std::size_t size, std::size_t minSize,
+                    std::vector<DocumentSpan>& spans) {
+  std::vector<Chunk> chunks;
+  chunks.push_back({0, 0, false, 0, 0});
+
+  const char* const end = data + size;
+  bool hasContent = false;
+  bool afterEnd = false;
+  int line = 0;
+  for (const char* p = data; p != end; line++) {
+    const void* newline =
+        std::memchr(p, '\n', static_cast<std::size_t>(end - p));
+    const char* next =
+        (newline ? static_cast<const char*>(newline) + 1 : end);
+
+    if (IsDocumentIndicator(p, end, '.')) {
+      afterEnd = true;
+    } else if (!IsEmptyLine(p, next)) {
+      const bool isDirective = *p == '%';
+      if (afterEnd || (hasContent && IsDocumentIndicator(p, end, '-'))) {
+        const std::size_t begin = static_cast<std::size_t>(p - data);
+        chunks.push_back({begin, line, false, 0, 0});
+        hasContent = false;
+        afterEnd = false;
+      }
+
+      if (isDirective) {
+        // after some content, this might just continue a plain scalar
+        if (hasContent)
+          return false;
+
+        Chunk& chunk = chunks.back();
+        if (!chunk.hasDirectives) {
+          chunk.hasDirectives = true;
+          chunk.directivesBegin = static_cast<std::size_t>(p - data);
+        }
+        chunk.directivesEnd = static_cast<std::size_t>(next - data);
+      } else {
+        hasContent = true;
+      }
+    }
+    p = next;
+  }
+
+  // group the documents into spans, each starting with the directives in
+  // effect for it
+  std::size_t directivesBegin = 0;
+  std::size_t directivesEnd = 0;
+  for (std::size_t i = 0; i < chunks.size();) {
+    const Chunk& first = chunks[i];
+    if (first.hasDirectives) {
+      directivesBegin = first.directivesBegin;
+      directivesEnd = first.directivesEnd;
+    }
+
+    DocumentSpan span{first.begin, size, first.line,
+                      first.hasDirectives ? 0 : directivesBegin,
+                      first.hasDirectives ? 0 : directivesEnd};
+    for (i++; i < chunks.size(); i++) {
+      if (chunks[i].begin - first.begin >= minSize) {
+        span.end = chunks[i].begin;
+        break;
+      }
+      if (chunks[i].hasDirectives) {
+        directivesBegin = chunks[i].directivesBegin;
+        directivesEnd = chunks[i].directivesEnd;
+      }
+    }
+    spans.push_back(span);
+  }
+  return true;
+}
+
+bool IsUtf8(const char* input, std::size_t size) {
+  for (std::size_t i = 0; i < std::min<std::size_t>(size, 4); i++) {
+    const unsigned char ch = static_cast<unsigned char>(input[i]);
+    if (ch == 0x00 || ((ch == 0xFE || ch == 0xFF) && i < 2)) {
+      return false;
+    }
+  }
+  return true;
+}
+}  // namespace YAML
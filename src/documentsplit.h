@@ -0,0 +1,53 @@
+#ifndef DOCUMENTSPLIT_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define DOCUMENTSPLIT_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <vector>
+
+namespace YAML {
+bool IsBlankOrBreak(char ch);
+
+// IsDocumentIndicator
+// . Returns true if the line is a document start ("---") or end ("...")
+//   marker, by the same rule as Exp::DocStart and Exp::DocEnd.
+bool IsDocumentIndicator(const char* line, const char* end, char ch);
+
+// IsEmptyLine
+// . Returns true if the line has nothing but whitespace or a comment.
+bool IsEmptyLine(const char* line, const char* end);
+
+// A run of whole documents cut out of a larger stream, which parses on its
+// own to the same documents as it does in place.
+struct DocumentSpan {
+  std::size_t begin;
+  std::size_t end;
+  int line;  // of begin, which is always at the start of a line
+
+  // If the span doesn't start with directives of its own, the byte range of
+  // the last ones before it, which a parser would still be using; empty if
+  // there are none.
+  std::size_t directivesBegin;
+  std::size_t directivesEnd;
+};
+
+// SplitDocuments
+// . Splits the (UTF-8) input at document boundaries into spans of at least
+//   minSize bytes (except the last).
+// . Returns false if the input can't be split safely, because a line that
+//   could be a directive appears where a Parser might read it either as a
+//   directive or as part of a scalar.
+bool SplitDocuments(const char* data, std::size_t size, std::size_t minSize,
+                    std::vector<DocumentSpan>& spans);
+
+// IsUtf8
+// . Guesses the encoding just as Stream does, from the first few bytes.
+bool IsUtf8(const char* input, std::size_t size);
+}  // namespace YAML
+
+#endif  // DOCUMENTSPLIT_H_62B23520_7C8E_11DE_8A39_0800200C9A66
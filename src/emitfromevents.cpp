@@ -41,7 +41,12 @@ void EmitFromEvents::OnScalar(const Mark&, const std::string& tag,
                               anchor_t anchor, const std::string& value) {
   BeginNode();
   EmitProps(tag, anchor);
-  m_emitter << value;
+  // only a plain scalar may be a number, bool or null; a quoted one ("!")
+  // or an explicitly tagged one stays a string
+  if (tag.empty() || tag == "?")
+    m_emitter.WritePlainScalar(value);
+  else
+    m_emitter << value;
 }
 
 void EmitFromEvents::OnSequenceStart(const Mark&, const std::string& tag,
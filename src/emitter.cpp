@@ -90,6 +90,10 @@ bool Emitter::SetDoublePrecision(std::size_t n) {
   return m_pState->SetDoublePrecision(n, FmtScope::Global);
 }
 
+bool Emitter::SetOutputFormat(EMITTER_MANIP value) {
+  return m_pState->SetOutputFormat(value, FmtScope::Global);
+}
+
 void Emitter::RestoreGlobalModifiedSettings() {
   m_pState->RestoreGlobalModifiedSettings();
 }
@@ -154,6 +158,9 @@ void Emitter::EmitBeginDoc() {
   if (!good())
     return;
 
+  if (m_pState->IsCompactJson())
+    return;
+
   if (m_pState->CurGroupType() != GroupType::NoType) {
     m_pState->SetError("Unexpected begin document");
     return;
@@ -176,6 +183,9 @@ void Emitter::EmitEndDoc() {
   if (!good())
     return;
 
+  if (m_pState->IsCompactJson())
+    return;
+
   if (m_pState->CurGroupType() != GroupType::NoType) {
     m_pState->SetError("Unexpected begin document");
     return;
@@ -196,6 +206,9 @@ void Emitter::EmitBeginSeq() {
   if (!good())
     return;
 
+  if (m_pState->IsCompactJson())
+    return JsonBeginGroup(true);
+
   PrepareNode(m_pState->NextGroupType(GroupType::Seq));
 
   m_pState->StartedGroup(GroupType::Seq);
@@ -205,6 +218,10 @@ void Emitter::EmitBeginSeq() {
 void Emitter::EmitEndSeq() {
   if (!good())
     return;
+
+  if (m_pState->IsCompactJson())
+    return JsonEndGroup(true);
+
   FlowType::value originalType = m_pState->CurGroupFlowType();
 
   if (m_pState->CurGroupChildCount() == 0)
@@ -231,6 +248,9 @@ void Emitter::EmitBeginMap() {
   if (!good())
     return;
 
+  if (m_pState->IsCompactJson())
+    return JsonBeginGroup(false);
+
   PrepareNode(m_pState->NextGroupType(GroupType::Map));
 
   m_pState->StartedGroup(GroupType::Map);
@@ -240,6 +260,10 @@ void Emitter::EmitBeginMap() {
 void Emitter::EmitEndMap() {
   if (!good())
     return;
+
+  if (m_pState->IsCompactJson())
+    return JsonEndGroup(false);
+
   FlowType::value originalType = m_pState->CurGroupFlowType();
 
   if (m_pState->CurGroupChildCount() == 0)
@@ -266,6 +290,9 @@ void Emitter::EmitNewline() {
   if (!good())
     return;
 
+  if (m_pState->IsCompactJson())
+    return;
+
   PrepareNode(EmitterNodeType::NoType);
   m_stream << "\n";
   m_pState->SetNonContent();
@@ -680,6 +707,11 @@ void Emitter::SpaceOrIndentTo(bool requireSpace, std::size_t indent) {
 }
 
 void Emitter::PrepareIntegralStream(std::stringstream& stream) const {
+  // JSON only has decimal numbers
+  if (m_pState->IsCompactJson()) {
+    stream << std::dec;
+    return;
+  }
 
   switch (m_pState->GetIntFormat()) {
     case Dec:
@@ -698,8 +730,118 @@ void Emitter::PrepareIntegralStream(std::stringstream& stream) const {
   }
 }
 
+void Emitter::WriteNumber(const std::string& number, bool finite) {
+  if (m_pState->IsCompactJson()) {
+    // JSON has no spelling for NaN or the infinities
+    if (finite)
+      JsonWriteLiteral(number.c_str(), number.size());
+    else
+      JsonWriteLiteral("null", 4);
+    return;
+  }
+
+  PrepareNode(EmitterNodeType::Scalar);
+  m_stream << number;
+  StartedScalar();
+}
+
 void Emitter::StartedScalar() { m_pState->StartedScalar(); }
 
+// *******************************************************************************************
+// compact JSON output
+//
+// A separate, much smaller state machine than the YAML one above: every node
+// is written with only the separator it needs, without spaces, newlines or
+// indentation. Strings and keys are always double-quoted (only a node's
+// plain scalar is written bare, if it reads as a number, bool or null), and
+// properties (tags, anchors) and comments have no JSON counterpart so they
+// are dropped.
+
+void Emitter::JsonBeginGroup(bool isSeq) {
+  if (JsonPrepareNode()) {
+    m_pState->SetError(ErrorMsg::JSON_KEY);
+    return;
+  }
+
+  m_stream << (isSeq ? '[' : '{');
+  m_pState->StartedJsonGroup(isSeq ? GroupType::Seq : GroupType::Map);
+}
+
+void Emitter::JsonEndGroup(bool isSeq) {
+  const GroupType::value type = isSeq ? GroupType::Seq : GroupType::Map;
+
+  if (m_pState->CurJsonGroupType() == type) {
+    // a dangling key still needs a value to be valid JSON
+    if (type == GroupType::Map && m_pState->CurJsonChildCount() % 2 == 1)
+      m_stream << ":null";
+    m_stream << (isSeq ? ']' : '}');
+  }
+
+  m_pState->EndedJsonGroup(type);
+}
+
+// JsonPrepareNode
+// . Writes the separator in front of the next node, and returns whether that
+//   node is a map key (and so must be quoted)
+bool Emitter::JsonPrepareNode() {
+  const std::size_t childCount = m_pState->CurJsonChildCount();
+
+  switch (m_pState->CurJsonGroupType()) {
+    case GroupType::NoType:
+      if (childCount > 0)
+        m_stream << '\n';
+      return false;
+    case GroupType::Seq:
+      if (childCount > 0)
+        m_stream << ',';
+      return false;
+    case GroupType::Map:
+      if (childCount % 2 == 1) {
+        m_stream << ':';
+        return false;
+      }
+      if (childCount > 0)
+        m_stream << ',';
+      return true;
+  }
+
+  assert(false);
+  return false;
+}
+
+void Emitter::JsonWriteLiteral(const char* str, std::size_t size) {
+  if (JsonPrepareNode()) {
+    m_stream << '"';
+    m_stream.write(str, size);
+    m_stream << '"';
+  } else {
+    m_stream.write(str, size);
+  }
+
+  m_pState->StartedJsonNode();
+}
+
+void Emitter::JsonWriteString(const std::string& str, bool allowLiteral) {
+  if (!JsonPrepareNode() && allowLiteral && Utils::IsJsonLiteral(str))
+    m_stream << str;
+  else
+    Utils::WriteDoubleQuotedString(m_stream, str, StringEscaping::JSON);
+
+  m_pState->StartedJsonNode();
+}
+
+Emitter& Emitter::WritePlainScalar(const std::string& str) {
+  if (!good())
+    return *this;
+
+  if (m_pState->IsCompactJson()) {
+    JsonWriteString(str, true);
+    return *this;
+  }
+
+  return Write(str);
+}
+
 // *******************************************************************************************
 // overloads of Write
 
@@ -719,6 +861,11 @@ Emitter& Emitter::Write(const std::string& str) {
   if (!good())
     return *this;
 
+  if (m_pState->IsCompactJson()) {
+    JsonWriteString(str, false);
+    return *this;
+  }
+
   StringEscaping::value stringEscaping = GetStringEscapingStyle(m_pState->GetOutputCharset());
 
   const StringFormat::value strFormat =
@@ -827,6 +974,14 @@ Emitter& Emitter::Write(bool b) {
   if (!good())
     return *this;
 
+  if (m_pState->IsCompactJson()) {
+    if (b)
+      JsonWriteLiteral("true", 4);
+    else
+      JsonWriteLiteral("false", 5);
+    return *this;
+  }
+
   PrepareNode(EmitterNodeType::Scalar);
 
   const char* name = ComputeFullBoolName(b);
@@ -844,7 +999,10 @@ Emitter& Emitter::Write(char ch) {
   if (!good())
     return *this;
 
-
+  if (m_pState->IsCompactJson()) {
+    JsonWriteString(std::string(1, ch), false);
+    return *this;
+  }
 
   PrepareNode(EmitterNodeType::Scalar);
   Utils::WriteChar(m_stream, ch, GetStringEscapingStyle(m_pState->GetOutputCharset()));
@@ -857,6 +1015,11 @@ Emitter& Emitter::Write(const _Alias& alias) {
   if (!good())
     return *this;
 
+  if (m_pState->IsCompactJson()) {
+    m_pState->SetError(ErrorMsg::JSON_ALIAS);
+    return *this;
+  }
+
   if (m_pState->HasAnchor() || m_pState->HasTag()) {
     m_pState->SetError(ErrorMsg::INVALID_ALIAS);
     return *this;
@@ -877,7 +1040,7 @@ Emitter& Emitter::Write(const _Alias& alias) {
 }
 
 Emitter& Emitter::Write(const _Anchor& anchor) {
-  if (!good())
+  if (!good() || m_pState->IsCompactJson())
     return *this;
 
   if (m_pState->HasAnchor()) {
@@ -898,7 +1061,7 @@ Emitter& Emitter::Write(const _Anchor& anchor) {
 }
 
 Emitter& Emitter::Write(const _Tag& tag) {
-  if (!good())
+  if (!good() || m_pState->IsCompactJson())
     return *this;
 
   if (m_pState->HasTag()) {
@@ -929,7 +1092,7 @@ Emitter& Emitter::Write(const _Tag& tag) {
 void Emitter::EmitKindTag() { Write(LocalTag("")); }
 
 Emitter& Emitter::Write(const _Comment& comment) {
-  if (!good())
+  if (!good() || m_pState->IsCompactJson())
     return *this;
 
   PrepareNode(EmitterNodeType::NoType);
@@ -948,6 +1111,11 @@ Emitter& Emitter::Write(const _Null& /*null*/) {
   if (!good())
     return *this;
 
+  if (m_pState->IsCompactJson()) {
+    JsonWriteLiteral("null", 4);
+    return *this;
+  }
+
   PrepareNode(EmitterNodeType::Scalar);
 
   m_stream << ComputeNullName();
@@ -963,6 +1131,13 @@ Emitter& Emitter::Write(const Binary& binary) {
   if (!good())
     return *this;
 
+  if (m_pState->IsCompactJson()) {
+    JsonPrepareNode();
+    Utils::WriteBinary(m_stream, binary);
+    m_pState->StartedJsonNode();
+    return *this;
+  }
+
   PrepareNode(EmitterNodeType::Scalar);
   Utils::WriteBinary(m_stream, binary);
   StartedScalar();
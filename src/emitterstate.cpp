@@ -23,10 +23,12 @@ EmitterState::EmitterState()
       m_mapKeyFmt(Auto),
       m_floatPrecision(std::numeric_limits<float>::max_digits10),
       m_doublePrecision(std::numeric_limits<double>::max_digits10),
+      m_outputFormat(Auto),
       //
       m_modifiedSettings{},
       m_globalModifiedSettings{},
       m_groups{},
+      m_jsonGroups{},
       m_curIndent(0),
       m_hasAnchor(false),
       m_hasAlias(false),
@@ -195,6 +197,38 @@ void EmitterState::EndedGroup(GroupType::value type) {
   m_hasNonContent = false;
 }
 
+void EmitterState::StartedJsonNode() {
+  if (m_jsonGroups.empty()) {
+    m_docCount++;
+  } else {
+    m_jsonGroups.back().childCount++;
+  }
+
+  ClearModifiedSettings();
+}
+
+void EmitterState::StartedJsonGroup(GroupType::value type) {
+  StartedJsonNode();
+  m_jsonGroups.push_back({type, 0});
+}
+
+void EmitterState::EndedJsonGroup(GroupType::value type) {
+  if (m_jsonGroups.empty()) {
+    if (type == GroupType::Seq) {
+      return SetError(ErrorMsg::UNEXPECTED_END_SEQ);
+    }
+    return SetError(ErrorMsg::UNEXPECTED_END_MAP);
+  }
+
+  const GroupType::value finishedType = m_jsonGroups.back().type;
+  m_jsonGroups.pop_back();
+  if (finishedType != type) {
+    return SetError(ErrorMsg::UNMATCHED_GROUP_TAG);
+  }
+
+  ClearModifiedSettings();
+}
+
 EmitterNodeType::value EmitterState::CurGroupNodeType() const {
   if (m_groups.empty()) {
     return EmitterNodeType::NoType;
@@ -397,4 +431,19 @@ bool EmitterState::SetDoublePrecision(std::size_t value,
   _Set(m_doublePrecision, value, scope);
   return true;
 }
+
+bool EmitterState::SetOutputFormat(EMITTER_MANIP value, FmtScope::value scope) {
+  // the output format can only change between top-level nodes
+  if (!m_groups.empty() || !m_jsonGroups.empty() || HasBegunNode())
+    return false;
+
+  switch (value) {
+    case Auto:
+    case CompactJson:
+      _Set(m_outputFormat, value, scope);
+      return true;
+    default:
+      return false;
+  }
+}
 }  // namespace YAML
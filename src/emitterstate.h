@@ -120,6 +120,23 @@ class EmitterState {
   bool SetDoublePrecision(std::size_t value, FmtScope::value scope);
   std::size_t GetDoublePrecision() const { return m_doublePrecision.get(); }
 
+  bool SetOutputFormat(EMITTER_MANIP value, FmtScope::value scope);
+  EMITTER_MANIP GetOutputFormat() const { return m_outputFormat.get(); }
+
+  // compact JSON output
+  // . keeps only the group kind and child count; there is no indentation or
+  //   per-group settings to track
+  bool IsCompactJson() const { return m_outputFormat.get() == CompactJson; }
+  void StartedJsonNode();
+  void StartedJsonGroup(GroupType::value type);
+  void EndedJsonGroup(GroupType::value type);
+  GroupType::value CurJsonGroupType() const {
+    return m_jsonGroups.empty() ? GroupType::NoType : m_jsonGroups.back().type;
+  }
+  std::size_t CurJsonChildCount() const {
+    return m_jsonGroups.empty() ? m_docCount : m_jsonGroups.back().childCount;
+  }
+
  private:
   template <typename T>
   void _Set(Setting<T>& fmt, T value, FmtScope::value scope);
@@ -146,6 +163,7 @@ class EmitterState {
   Setting<EMITTER_MANIP> m_mapKeyFmt;
   Setting<std::size_t> m_floatPrecision;
   Setting<std::size_t> m_doublePrecision;
+  Setting<EMITTER_MANIP> m_outputFormat;
 
   SettingChanges m_modifiedSettings;
   SettingChanges m_globalModifiedSettings;
@@ -187,6 +205,13 @@ class EmitterState {
   };
 
   std::vector<std::unique_ptr<Group>> m_groups;
+
+  struct JsonGroup {
+    GroupType::value type;
+    std::size_t childCount;
+  };
+
+  std::vector<JsonGroup> m_jsonGroups;
   std::size_t m_curIndent;
   bool m_hasAnchor;
   bool m_hasAlias;
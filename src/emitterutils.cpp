@@ -296,6 +296,49 @@ StringFormat::value ComputeStringFormat(const std::string& str,
   return StringFormat::DoubleQuoted;
 }
 
+// IsJsonLiteral
+// . true if the string is a JSON number, true, false or null, i.e. it can be
+//   written without quotes in JSON output
+bool IsJsonLiteral(const std::string& str) {
+  if (str == "true" || str == "false" || str == "null")
+    return true;
+
+  auto isDigit = [](char ch) { return '0' <= ch && ch <= '9'; };
+  std::string::const_iterator it = str.begin();
+  const std::string::const_iterator end = str.end();
+
+  if (it != end && *it == '-')
+    ++it;
+  if (it == end || !isDigit(*it))
+    return false;
+  if (*it == '0') {
+    ++it;
+  } else {
+    while (it != end && isDigit(*it))
+      ++it;
+  }
+
+  if (it != end && *it == '.') {
+    ++it;
+    if (it == end || !isDigit(*it))
+      return false;
+    while (it != end && isDigit(*it))
+      ++it;
+  }
+
+  if (it != end && (*it == 'e' || *it == 'E')) {
+    ++it;
+    if (it != end && (*it == '+' || *it == '-'))
+      ++it;
+    if (it == end || !isDigit(*it))
+      return false;
+    while (it != end && isDigit(*it))
+      ++it;
+  }
+
+  return it == end;
+}
+
 bool WriteSingleQuotedString(ostream_wrapper& out, const std::string& str) {
   out << "'";
   int codePoint;
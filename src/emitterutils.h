@@ -34,6 +34,8 @@ StringFormat::value ComputeStringFormat(const std::string& str,
                                         FlowType::value flowType,
                                         bool escapeNonAscii);
 
+bool IsJsonLiteral(const std::string& str);
+
 bool WriteSingleQuotedString(ostream_wrapper& out, const std::string& str);
 bool WriteDoubleQuotedString(ostream_wrapper& out, const std::string& str,
                              StringEscaping::value stringEscaping);
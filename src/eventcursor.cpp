@@ -0,0 +1,140 @@
+#include "yaml-cpp/eventcursor.h"
+
+#include "directives.h"  // IWYU pragma: keep
+#include "eventqueue.h"
+#include "scanner.h"  // IWYU pragma: keep
+#include "singledocparser.h"
+#include "yaml-cpp/parser.h"
+
+namespace YAML {
+Event::Event()
+    : type(Type::StreamEnd),
+      mark(Mark::null_mark()),
+      tag{},
+      anchor(NullAnchor),
+      value{},
+      style(EmitterStyle::Default) {}
+
+EventCursor::EventCursor(Parser& parser)
+    : m_parser(parser),
+      m_pDocument{},
+      m_pQueue(new EventQueue),
+      m_isQueued(false),
+      m_event{},
+      m_type(Event::Type::StreamEnd),
+      m_depth(0) {}
+
+EventCursor::~EventCursor() = default;
+
+const Event& EventCursor::next() {
+  Pop();
+  if (!Fill()) {
+    m_event = Event();
+    m_type = m_event.type;
+    return m_event;
+  }
+
+  const Event& event = m_pQueue->front();
+  m_isQueued = true;
+  m_type = event.type;
+  Update(event);
+  return event;
+}
+
+void EventCursor::skip() {
+  const Event::Type::value type = m_type;
+  if (type != Event::Type::SequenceStart && type != Event::Type::MapStart &&
+      type != Event::Type::DocumentStart) {
+    return;
+  }
+  Pop();
+
+  // first drop whatever the last step queued past the event just read
+  const std::size_t target =
+      (type == Event::Type::DocumentStart ? 0 : m_depth - 1);
+  while (!m_pQueue->empty()) {
+    const Event::Type::value queued = m_pQueue->front().type;
+    Update(m_pQueue->front());
+    m_pQueue->pop();
+    if (queued == Event::Type::DocumentEnd ||
+        (type != Event::Type::DocumentStart && m_depth == target)) {
+      m_event = Event();
+      m_event.type = m_type = queued;
+      return;
+    }
+  }
+
+  // then parse the rest of it without recording anything
+  EventSkipper skipper;
+  while (m_pDocument->Depth() > target)
+    m_pDocument->HandleNextState(skipper);
+  m_depth = target;
+
+  m_event = Event();
+  if (type == Event::Type::DocumentStart) {
+    m_pDocument->EndDocument(skipper);
+    m_pDocument.reset();
+    m_event.type = Event::Type::DocumentEnd;
+  } else {
+    m_event.type = (type == Event::Type::SequenceStart
+                        ? Event::Type::SequenceEnd
+                        : Event::Type::MapEnd);
+  }
+  m_type = m_event.type;
+}
+
+void EventCursor::Pop() {
+  if (m_isQueued) {
+    m_pQueue->pop();
+    m_isQueued = false;
+  }
+}
+
+// Fill
+// . Steps the parser until it has queued at least one event, starting the
+//   next document if the current one is done.
+// . Returns false if there are no more documents.
+bool EventCursor::Fill() {
+  while (m_pQueue->empty()) {
+    if (m_pDocument) {
+      if (m_pDocument->Depth() > 0) {
+        m_pDocument->HandleNextState(*m_pQueue);
+      } else {
+        m_pDocument->EndDocument(*m_pQueue);
+        m_pDocument.reset();
+      }
+      continue;
+    }
+
+    if (!m_parser.m_pScanner)
+      return false;
+
+    // the cursor reads through the scanner, so the index is never used
+    m_parser.m_isIndexable = false;
+    m_parser.ParseDirectives();
+    if (m_parser.m_pScanner->empty())
+      return false;
+
+    m_pDocument.reset(new SingleDocParser(
+        *m_parser.m_pScanner, *m_parser.m_pDirectives, m_parser.m_maxDepth,
+        m_parser.m_maxAnchors));
+    m_pDocument->StartDocument(*m_pQueue);
+  }
+  return true;
+}
+
+void EventCursor::Update(const Event& event) {
+  switch (event.type) {
+    case Event::Type::SequenceStart:
+    case Event::Type::MapStart:
+      m_depth++;
+      break;
+    case Event::Type::SequenceEnd:
+    case Event::Type::MapEnd:
+      m_depth--;
+      break;
+    default:
+      break;
+  }
+}
+}  // namespace YAML
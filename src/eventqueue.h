@@ -0,0 +1,117 @@
+#ifndef EVENTQUEUE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define EVENTQUEUE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "yaml-cpp/anchor.h"
+#include "yaml-cpp/emitterstyle.h"
+#include "yaml-cpp/eventcursor.h"
+#include "yaml-cpp/mark.h"
+
+namespace YAML {
+// Records the events of a single parser step for an EventCursor. A step
+// emits only a handful of events, so this never grows beyond that; the
+// events are reused once they're read, strings and all, so that recording
+// one doesn't allocate.
+class EventQueue {
+ public:
+  EventQueue() : m_events{}, m_front(0), m_size(0) {}
+
+  bool empty() const { return m_front == m_size; }
+  Event& front() { return m_events[m_front]; }
+  void pop() {
+    if (++m_front == m_size)
+      m_front = m_size = 0;
+  }
+
+  void OnDocumentStart(const Mark& mark) {
+    Push(Event::Type::DocumentStart, mark);
+  }
+  void OnDocumentEnd() { Push(Event::Type::DocumentEnd, Mark::null_mark()); }
+
+  void OnNull(const Mark& mark, anchor_t anchor) {
+    Push(Event::Type::Null, mark).anchor = anchor;
+  }
+  void OnAlias(const Mark& mark, anchor_t anchor) {
+    Push(Event::Type::Alias, mark).anchor = anchor;
+  }
+  void OnScalar(const Mark& mark, const std::string& tag, anchor_t anchor,
+                const std::string& value) {
+    Event& event = Push(Event::Type::Scalar, mark);
+    event.tag = tag;
+    event.anchor = anchor;
+    event.value = value;
+  }
+
+  void OnSequenceStart(const Mark& mark, const std::string& tag,
+                       anchor_t anchor, EmitterStyle::value style) {
+    Event& event = Push(Event::Type::SequenceStart, mark);
+    event.tag = tag;
+    event.anchor = anchor;
+    event.style = style;
+  }
+  void OnSequenceEnd() { Push(Event::Type::SequenceEnd, Mark::null_mark()); }
+
+  void OnMapStart(const Mark& mark, const std::string& tag, anchor_t anchor,
+                  EmitterStyle::value style) {
+    Event& event = Push(Event::Type::MapStart, mark);
+    event.tag = tag;
+    event.anchor = anchor;
+    event.style = style;
+  }
+  void OnMapEnd() { Push(Event::Type::MapEnd, Mark::null_mark()); }
+
+  void OnAnchor(const Mark&, const std::string&) {}
+
+ private:
+  Event& Push(Event::Type::value type, const Mark& mark) {
+    if (m_size == m_events.size())
+      m_events.emplace_back();
+    Event& event = m_events[m_size++];
+    event.type = type;
+    event.mark = mark;
+    event.tag.clear();
+    event.anchor = NullAnchor;
+    event.value.clear();
+    event.style = EmitterStyle::Default;
+    return event;
+  }
+
+ private:
+  std::vector<Event> m_events;
+  std::size_t m_front, m_size;
+};
+
+// Drops every event; used to parse past the parts of a document a caller has
+// skipped.
+class EventSkipper {
+ public:
+  void OnDocumentStart(const Mark&) {}
+  void OnDocumentEnd() {}
+
+  void OnNull(const Mark&, anchor_t) {}
+  void OnAlias(const Mark&, anchor_t) {}
+  void OnScalar(const Mark&, const std::string&, anchor_t,
+                const std::string&) {}
+
+  void OnSequenceStart(const Mark&, const std::string&, anchor_t,
+                       EmitterStyle::value) {}
+  void OnSequenceEnd() {}
+
+  void OnMapStart(const Mark&, const std::string&, anchor_t,
+                  EmitterStyle::value) {}
+  void OnMapEnd() {}
+
+  void OnAnchor(const Mark&, const std::string&) {}
+};
+}  // namespace YAML
+
+#endif  // EVENTQUEUE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
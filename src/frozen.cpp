@@ -0,0 +1,329 @@
+#include "yaml-cpp/node/frozen.h"
+
+#include <algorithm>
+#include <limits>
+#include <string>
+#include <unordered_map>
+
+#include "yaml-cpp/exceptions.h"
+#include "yaml-cpp/node/convert.h"
+#include "yaml-cpp/node/detail/impl.h"
+#include "yaml-cpp/node/detail/memory.h"
+#include "yaml-cpp/node/detail/node.h"
+#include "yaml-cpp/node/detail/node_iterator.h"
+#include "yaml-cpp/node/impl.h"
+
+namespace YAML {
+namespace {
+const std::uint32_t NoEntry = std::numeric_limits<std::uint32_t>::max();
+
+const std::string& EmptyString() {
+  static const std::string empty;
+  return empty;
+}
+}  // namespace
+
+// Copies a node graph into the nodes of a FrozenDocument, entry by entry,
+// in the order the nodes are first reached.
+class FrozenBuilder {
+ public:
+  explicit FrozenBuilder(detail::frozen_data& document)
+      : m_document(document),
+        m_root(nullptr),
+        m_indexByIdentity{},
+        m_indexByString{} {}
+
+  FrozenBuilder(const FrozenBuilder&) = delete;
+  FrozenBuilder& operator=(const FrozenBuilder&) = delete;
+
+  void Build(const Node& node) {
+    if (!node.IsValid())
+      throw InvalidNode(node.InvalidKey());
+
+    Intern(EmptyString());  // so an untagged node's tag is string 0
+    if (!node.m_pNode) {
+      m_document.entries.push_back(
+          {NodeType::Null, EmitterStyle::Default, false, 0, 0, 0});
+      return;
+    }
+    m_root = node.m_pNode;
+    Add(*m_root);
+  }
+
+ private:
+  using Entry = detail::frozen_data::Entry;
+
+  std::uint32_t Add(const detail::node& node) {
+    // as when emitting, a node that was never shared is reached exactly once
+    // (the root aside, which a cycle may reach again)
+    const std::uint32_t index =
+        static_cast<std::uint32_t>(m_document.entries.size());
+    if (node.is_shared() || (&node == m_root && node.is_attached())) {
+      auto inserted = m_indexByIdentity.emplace(node.ref(), index);
+      if (!inserted.second) {
+        m_document.entries[inserted.first->second].isShared = true;
+        return inserted.first->second;
+      }
+    }
+
+    const NodeType::value type = node.type();
+    m_document.entries.push_back(
+        {static_cast<std::uint8_t>(type),
+         static_cast<std::uint8_t>(node.style()), false, Intern(node.tag()),
+         0, 0});
+
+    switch (type) {
+      case NodeType::Scalar:
+        m_document.entries[index].value = Intern(node.scalar());
+        break;
+      case NodeType::Sequence:
+        AddSequence(node, index);
+        break;
+      case NodeType::Map:
+        AddMap(node, index);
+        break;
+      default:
+        break;
+    }
+    return index;
+  }
+
+  // the children's slots are set aside first, since adding the children
+  // appends their own children after them
+  void AddSequence(const detail::node& node, std::uint32_t index) {
+    std::vector<std::uint32_t>& children = m_document.children;
+    const std::uint32_t size = static_cast<std::uint32_t>(node.size());
+    const std::uint32_t first = static_cast<std::uint32_t>(children.size());
+    children.resize(first + size);
+    m_document.entries[index].value = first;
+    m_document.entries[index].size = size;
+
+    if (const detail::packed_numbers* pPacked = node.packed()) {
+      for (std::uint32_t i = 0; i < size; i++)
+        children[first + i] = AddPacked(pPacked->text(i));
+      return;
+    }
+
+    std::uint32_t i = 0;
+    for (auto element : node) {
+      if (i == size)
+        break;
+      const std::uint32_t child = Add(*element);
+      children[first + i++] = child;
+    }
+  }
+
+  // a packed number is added as the plain scalar it was loaded from
+  std::uint32_t AddPacked(const std::string& text) {
+    const std::uint32_t index =
+        static_cast<std::uint32_t>(m_document.entries.size());
+    m_document.entries.push_back({NodeType::Scalar, EmitterStyle::Default,
+                                  false, Intern("?"), Intern(text), 0});
+    return index;
+  }
+
+  void AddMap(const detail::node& node, std::uint32_t index) {
+    std::vector<std::uint32_t>& children = m_document.children;
+    const std::uint32_t size = static_cast<std::uint32_t>(node.size());
+    const std::uint32_t first = static_cast<std::uint32_t>(children.size());
+    children.resize(first + 3 * size);
+    m_document.entries[index].value = first;
+    m_document.entries[index].size = size;
+
+    std::uint32_t i = 0;
+    for (auto element : node) {
+      if (i == size)
+        break;
+      const std::uint32_t key = Add(*element.first);
+      children[first + 2 * i] = key;
+      const std::uint32_t value = Add(*element.second);
+      children[first + 2 * i + 1] = value;
+      i++;
+    }
+
+    // the key index: scalar keys in order, then the rest; the sort is stable
+    // so that, of equal keys, the first one inserted is found, as in a Node
+    const auto order = children.begin() + first + 2 * size;
+    for (std::uint32_t pair = 0; pair < size; pair++)
+      order[pair] = pair;
+    std::stable_sort(order, order + size,
+                     [&](std::uint32_t lhs, std::uint32_t rhs) {
+                       return KeyLess(children[first + 2 * lhs],
+                                      children[first + 2 * rhs]);
+                     });
+  }
+
+  bool KeyLess(std::uint32_t lhs, std::uint32_t rhs) const {
+    const Entry& left = m_document.entries[lhs];
+    const Entry& right = m_document.entries[rhs];
+    if (left.type != NodeType::Scalar || right.type != NodeType::Scalar)
+      return left.type == NodeType::Scalar && right.type != NodeType::Scalar;
+    return m_document.strings[left.value] < m_document.strings[right.value];
+  }
+
+  std::uint32_t Intern(const std::string& text) {
+    auto inserted = m_indexByString.emplace(
+        text, static_cast<std::uint32_t>(m_document.strings.size()));
+    if (inserted.second)
+      m_document.strings.push_back(text);
+    return inserted.first->second;
+  }
+
+  detail::frozen_data& m_document;
+  const detail::node* m_root;
+  std::unordered_map<const detail::node_ref*, std::uint32_t>
+      m_indexByIdentity;
+  std::unordered_map<std::string, std::uint32_t> m_indexByString;
+};
+
+FrozenDocument Freeze(const Node& node) {
+  FrozenDocument document;
+  FrozenBuilder(*document.m_pData).Build(node);
+  return document;
+}
+
+FrozenDocument::FrozenDocument() : m_pData(new detail::frozen_data) {}
+
+FrozenDocument::~FrozenDocument() = default;
+
+// Find
+// . Binary searches the map's key index, in which the scalar keys come
+//   first, in order; returns the value's entry, or NoEntry.
+std::uint32_t detail::frozen_data::Find(const Entry& map, const char* key,
+                                        std::size_t length) const {
+  const std::uint32_t* pairs = children.data() + map.value;
+  const std::uint32_t* order = pairs + 2 * map.size;
+  auto keyOf = [&](std::uint32_t pair) -> const Entry& {
+    return entries[pairs[2 * pair]];
+  };
+
+  const std::uint32_t* it = std::lower_bound(
+      order, order + map.size, key, [&](std::uint32_t pair, const char*) {
+        const Entry& entry = keyOf(pair);
+        return entry.type == NodeType::Scalar &&
+               strings[entry.value].compare(0, std::string::npos, key,
+                                            length) < 0;
+      });
+  if (it == order + map.size)
+    return NoEntry;
+
+  const Entry& entry = keyOf(*it);
+  if (entry.type != NodeType::Scalar ||
+      strings[entry.value].compare(0, std::string::npos, key, length) != 0)
+    return NoEntry;
+  return pairs[2 * *it + 1];
+}
+
+const std::string& FrozenNode::Scalar() const {
+  if (!IsScalar())
+    return EmptyString();
+  return m_pData->strings[m_pData->entry(m_index)->value];
+}
+
+const std::string& FrozenNode::Tag() const {
+  if (!IsDefined())
+    return EmptyString();
+  return m_pData->strings[m_pData->entry(m_index)->tag];
+}
+
+EmitterStyle::value FrozenNode::Style() const {
+  if (!IsDefined())
+    return EmitterStyle::Default;
+  return static_cast<EmitterStyle::value>(m_pData->entry(m_index)->style);
+}
+
+std::size_t FrozenNode::size() const {
+  if (!IsSequence() && !IsMap())
+    return 0;
+  return m_pData->entry(m_index)->size;
+}
+
+FrozenNode::const_iterator FrozenNode::begin() const {
+  if (!IsSequence() && !IsMap())
+    return const_iterator();
+  const detail::frozen_data::Entry& entry = *m_pData->entry(m_index);
+  return const_iterator(m_pData, m_pData->children.data() + entry.value,
+                        IsMap());
+}
+
+FrozenNode::const_iterator FrozenNode::end() const {
+  if (!IsSequence() && !IsMap())
+    return const_iterator();
+  const detail::frozen_data::Entry& entry = *m_pData->entry(m_index);
+  return const_iterator(m_pData,
+                        m_pData->children.data() + entry.value +
+                            (IsMap() ? 2 * entry.size : entry.size),
+                        IsMap());
+}
+
+FrozenNode FrozenNode::operator[](const std::string& key) const {
+  if (!IsMap())
+    return FrozenNode();
+  return FrozenNode(m_pData, m_pData->Find(*m_pData->entry(m_index),
+                                           key.data(), key.size()));
+}
+
+FrozenNode FrozenNode::operator[](const char* key) const {
+  if (!IsMap())
+    return FrozenNode();
+  return FrozenNode(m_pData,
+                    m_pData->Find(*m_pData->entry(m_index), key,
+                                  std::char_traits<char>::length(key)));
+}
+
+// a map may have integer keys, which are looked up by their text
+FrozenNode FrozenNode::operator[](std::size_t index) const {
+  if (IsMap())
+    return (*this)[std::to_string(index)];
+  if (!IsSequence() || index >= size())
+    return FrozenNode();
+  const detail::frozen_data::Entry& entry = *m_pData->entry(m_index);
+  return FrozenNode(m_pData, m_pData->children[entry.value + index]);
+}
+
+// Thawer
+// . A node reached from several places is thawed once, and aliased after
+//   that; it's remembered before its children are thawed, in case they
+//   reach it again.
+class FrozenNode::Thawer {
+ public:
+  Thawer() : m_thawedByIndex{} {}
+
+  Node Thaw(const FrozenNode& node) {
+    const detail::frozen_data::Entry& entry =
+        *node.m_pData->entry(node.m_index);
+    if (entry.isShared) {
+      auto it = m_thawedByIndex.find(node.m_index);
+      if (it != m_thawedByIndex.end())
+        return it->second;
+    }
+
+    Node thawed(node.Type());
+    if (node.IsScalar())
+      thawed = node.Scalar();
+    if (!node.Tag().empty())
+      thawed.SetTag(node.Tag());
+    if (node.Style() != EmitterStyle::Default)
+      thawed.SetStyle(node.Style());
+    if (entry.isShared)
+      m_thawedByIndex.emplace(node.m_index, thawed);
+
+    for (auto element : node) {
+      if (node.IsSequence())
+        thawed.push_back(Thaw(element));
+      else
+        thawed.force_insert(Thaw(element.first), Thaw(element.second));
+    }
+    return thawed;
+  }
+
+ private:
+  std::unordered_map<std::uint32_t, Node> m_thawedByIndex;
+};
+
+Node FrozenNode::Thaw() const {
+  if (!IsDefined())
+    return Node(NodeType::Undefined);
+  return Thawer().Thaw(*this);
+}
+}  // namespace YAML
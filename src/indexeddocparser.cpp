@@ -0,0 +1,426 @@
+#include "indexeddocparser.h"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "nodebuilder.h"
+#include "structuralindex.h"
+#include "yaml-cpp/anchor.h"
+#include "yaml-cpp/emitterstyle.h"
+#include "yaml-cpp/eventhandler.h"
+#include "yaml-cpp/mark.h"
+
+namespace YAML {
+namespace {
+// as Scanner::VerifySimpleKey has it, from the start of the key to the ':'
+const std::size_t MaxSimpleKeyLength = 1024;
+
+const std::string& PlainTag() {
+  static const std::string tag("?");
+  return tag;
+}
+
+const std::string& NonPlainTag() {
+  static const std::string tag("!");
+  return tag;
+}
+
+bool IsDigit(char ch) { return ch >= '0' && ch <= '9'; }
+
+int HexValue(char ch) {
+  if (IsDigit(ch))
+    return ch - '0';
+  if (ch >= 'a' && ch <= 'f')
+    return ch - 'a' + 10;
+  if (ch >= 'A' && ch <= 'F')
+    return ch - 'A' + 10;
+  return -1;
+}
+
+// ParseHex4
+// . The value of the four hex digits at text, or -1 if they aren't.
+long ParseHex4(const char* text) {
+  long value = 0;
+  for (int i = 0; i < 4; i++) {
+    const int digit = HexValue(text[i]);
+    if (digit < 0)
+      return -1;
+    value = value * 16 + digit;
+  }
+  return value;
+}
+
+// IsJsonLiteral
+// . Returns true if the text is a JSON number, true, false or null, all of
+//   which the scanner reads as plain scalars of just that text.
+bool IsJsonLiteral(const char* begin, const char* end) {
+  const std::size_t length = static_cast<std::size_t>(end - begin);
+  if ((length == 4 && (std::memcmp(begin, "true", 4) == 0 ||
+                       std::memcmp(begin, "null", 4) == 0)) ||
+      (length == 5 && std::memcmp(begin, "false", 5) == 0))
+    return true;
+
+  const char* p = begin;
+  if (p != end && *p == '-')
+    p++;
+  if (p == end || !IsDigit(*p))
+    return false;
+  if (*p++ != '0') {
+    while (p != end && IsDigit(*p))
+      p++;
+  }
+  if (p != end && *p == '.') {
+    const char* digits = ++p;
+    while (p != end && IsDigit(*p))
+      p++;
+    if (p == digits)
+      return false;
+  }
+  if (p != end && (*p == 'e' || *p == 'E')) {
+    p++;
+    if (p != end && (*p == '+' || *p == '-'))
+      p++;
+    const char* digits = p;
+    while (p != end && IsDigit(*p))
+      p++;
+    if (p == digits)
+      return false;
+  }
+  return p == end;
+}
+
+// IsJsonEscape
+// . Returns true if the escape at text (just past the backslash) is one
+//   JSON has, and that Exp::Escape reads the same way: it doesn't take the
+//   surrogates that JSON pairs up in \u escapes.
+bool IsJsonEscape(const char* text, const char* end) {
+  if (text == end)
+    return false;
+  switch (*text) {
+    case '"':
+    case '\\':
+    case '/':
+    case 'b':
+    case 'f':
+    case 'n':
+    case 'r':
+    case 't':
+      return true;
+    case 'u': {
+      if (end - text < 5)
+        return false;
+      const long value = ParseHex4(text + 1);
+      return value >= 0 && (value < 0xD800 || value > 0xDFFF);
+    }
+    default:
+      return false;
+  }
+}
+
+// AppendUtf8
+// . As Exp::Escape encodes the value of a \u escape.
+void AppendUtf8(unsigned long value, std::string& out) {
+  if (value <= 0x7F) {
+    out += static_cast<char>(value);
+  } else if (value <= 0x7FF) {
+    out += static_cast<char>(0xC0 + (value >> 6));
+    out += static_cast<char>(0x80 + (value & 0x3F));
+  } else {
+    out += static_cast<char>(0xE0 + (value >> 12));
+    out += static_cast<char>(0x80 + ((value >> 6) & 0x3F));
+    out += static_cast<char>(0x80 + (value & 0x3F));
+  }
+}
+
+// Unescape
+// . Decodes the text of a string that passed IsPlainJson into out.
+void Unescape(const char* text, const char* end, std::string& out) {
+  out.clear();
+  while (text != end) {
+    const char* slash = static_cast<const char*>(
+        std::memchr(text, '\\', static_cast<std::size_t>(end - text)));
+    if (!slash) {
+      out.append(text, end);
+      return;
+    }
+    out.append(text, slash);
+    text = slash + 2;
+    switch (slash[1]) {
+      case 'b':
+        out += '\b';
+        break;
+      case 'f':
+        out += '\f';
+        break;
+      case 'n':
+        out += '\n';
+        break;
+      case 'r':
+        out += '\r';
+        break;
+      case 't':
+        out += '\t';
+        break;
+      case 'u':
+        AppendUtf8(static_cast<unsigned long>(ParseHex4(text)), out);
+        text += 4;
+        break;
+      default:  // '"', '\\' or '/', which stand for themselves
+        out += slash[1];
+        break;
+    }
+  }
+}
+
+// The sinks that IndexedDocParser::Walk calls for each node it reads: one
+// that ignores them, to check the input, and one that emits them.
+struct Checker {
+  void DocumentStart(const Mark&) {}
+  void CollectionStart(const Mark&, bool) {}
+  void CollectionEnd(bool) {}
+  void Literal(const Mark&, const char*, const char*) {}
+  void String(const Mark&, const char*, const char*, bool) {}
+  void DocumentEnd() {}
+};
+
+template <typename Handler>
+class Emitter {
+ public:
+  explicit Emitter(Handler& eventHandler)
+      : m_eventHandler(eventHandler), m_value{} {}
+  Emitter(const Emitter&) = delete;
+  Emitter& operator=(const Emitter&) = delete;
+
+  void DocumentStart(const Mark& mark) {
+    m_eventHandler.OnDocumentStart(mark);
+  }
+
+  void CollectionStart(const Mark& mark, bool isMap) {
+    if (isMap)
+      m_eventHandler.OnMapStart(mark, PlainTag(), NullAnchor,
+                                EmitterStyle::Flow);
+    else
+      m_eventHandler.OnSequenceStart(mark, PlainTag(), NullAnchor,
+                                     EmitterStyle::Flow);
+  }
+
+  void CollectionEnd(bool isMap) {
+    if (isMap)
+      m_eventHandler.OnMapEnd();
+    else
+      m_eventHandler.OnSequenceEnd();
+  }
+
+  void Literal(const Mark& mark, const char* begin, const char* end) {
+    if (end - begin == 4 && std::memcmp(begin, "null", 4) == 0) {
+      m_eventHandler.OnNull(mark, NullAnchor);
+      return;
+    }
+    m_value.assign(begin, end);
+    m_eventHandler.OnScalar(mark, PlainTag(), NullAnchor, m_value);
+  }
+
+  void String(const Mark& mark, const char* begin, const char* end,
+              bool hasEscapes) {
+    if (hasEscapes)
+      Unescape(begin, end, m_value);
+    else
+      m_value.assign(begin, end);
+    m_eventHandler.OnScalar(mark, NonPlainTag(), NullAnchor, m_value);
+  }
+
+  void DocumentEnd() { m_eventHandler.OnDocumentEnd(); }
+
+ private:
+  Handler& m_eventHandler;
+  std::string m_value;  // reused, so that most scalars don't allocate
+};
+}  // namespace
+
+IndexedDocParser::IndexedDocParser(const char* input, std::size_t size,
+                                   const StructuralIndex& index,
+                                   std::size_t maxDepth)
+    : m_input(input), m_size(size), m_index(index), m_maxDepth(maxDepth) {}
+
+bool IndexedDocParser::MayBeJson(const char* input, std::size_t size) {
+  if (size > StructuralIndex::MaxSize)
+    return false;
+  const char* const end = input + size;
+  while (input != end &&
+         (*input == ' ' || *input == '\t' || *input == '\r' || *input == '\n'))
+    input++;
+  return input != end && (*input == '{' || *input == '[');
+}
+
+bool IndexedDocParser::IsPlainJson() const {
+  Checker checker;
+  return Walk(checker);
+}
+
+template <typename Handler>
+void IndexedDocParser::HandleDocument(Handler& eventHandler) const {
+  Emitter<Handler> emitter(eventHandler);
+  Walk(emitter);
+}
+
+// Walk
+// . Reads the input from one structural byte to the next, calling the sink
+//   for each node, and returns false as soon as the input turns out not to
+//   be plain JSON.
+// . Between two structural bytes, there can only be spaces, and a number,
+//   true, false or null where a value is due. A string runs from a quote to
+//   the next one that isn't escaped, and the bytes in it that aren't
+//   structural are never looked at.
+// . The line breaks are structural, so the marks are counted as they pass.
+template <typename Sink>
+bool IndexedDocParser::Walk(Sink& sink) const {
+  enum Expect {
+    Document,
+    Value,
+    ValueOrEnd,  // the first entry of a sequence
+    Key,
+    KeyOrEnd,  // the first key of a map
+    Colon,
+    SeparatorOrEnd,
+    Done
+  };
+
+  const std::vector<std::uint32_t>& positions = m_index.positions();
+  std::vector<bool> isMap;  // of each open collection
+  Expect expect = Document;
+  int line = 0;
+  std::size_t lineStart = 0;
+  std::size_t key = 0;
+  int keyLine = 0;
+
+  auto markAt = [&](std::size_t pos) {
+    Mark mark;
+    mark.pos = static_cast<int>(pos);
+    mark.line = line;
+    mark.column = static_cast<int>(pos - lineStart);
+    return mark;
+  };
+  auto endValue = [&] { expect = isMap.empty() ? Done : SeparatorOrEnd; };
+
+  std::size_t text = 0;  // where the text after the last structural byte is
+  for (std::size_t i = 0; i <= positions.size(); i++) {
+    const std::size_t pos = i < positions.size() ? positions[i] : m_size;
+
+    const char* begin = m_input + text;
+    const char* end = m_input + pos;
+    while (begin != end && *begin == ' ')
+      begin++;
+    while (end != begin && end[-1] == ' ')
+      end--;
+    if (begin != end) {
+      if ((expect != Value && expect != ValueOrEnd) ||
+          !IsJsonLiteral(begin, end))
+        return false;
+      sink.Literal(markAt(static_cast<std::size_t>(begin - m_input)), begin,
+                   end);
+      endValue();
+    }
+    if (pos == m_size)
+      break;
+
+    text = pos + 1;
+    const char ch = m_input[pos];
+    switch (ch) {
+      case '\n':
+        line++;
+        lineStart = pos + 1;
+        break;
+      case '\t':
+      case '\r':
+        break;
+      case '{':
+      case '[':
+        if (expect == Document)
+          sink.DocumentStart(markAt(pos));
+        else if (expect != Value && expect != ValueOrEnd)
+          return false;
+        if (isMap.size() >= m_maxDepth)
+          return false;
+        sink.CollectionStart(markAt(pos), ch == '{');
+        isMap.push_back(ch == '{');
+        expect = ch == '{' ? KeyOrEnd : ValueOrEnd;
+        break;
+      case '}':
+      case ']':
+        if (isMap.empty() || isMap.back() != (ch == '}') ||
+            (expect != SeparatorOrEnd &&
+             expect != (ch == '}' ? KeyOrEnd : ValueOrEnd)))
+          return false;
+        isMap.pop_back();
+        sink.CollectionEnd(ch == '}');
+        endValue();
+        break;
+      case ',':
+        if (expect != SeparatorOrEnd)
+          return false;
+        expect = isMap.back() ? Key : Value;
+        break;
+      case ':':
+        if (expect != Colon || line != keyLine ||
+            pos - key > MaxSimpleKeyLength)
+          return false;
+        expect = Value;
+        break;
+      case '"': {
+        const bool isKey = expect == Key || expect == KeyOrEnd;
+        if (!isKey && expect != Value && expect != ValueOrEnd)
+          return false;
+
+        bool hasEscapes = false;
+        std::size_t close = m_size;
+        while (++i < positions.size()) {
+          const std::size_t at = positions[i];
+          const char c = m_input[at];
+          if (c == '"') {
+            close = at;
+            break;
+          }
+          if (c == '\\') {
+            if (!IsJsonEscape(m_input + at + 1, m_input + m_size))
+              return false;
+            hasEscapes = true;
+            // an escaped quote or backslash is structural too
+            if (m_input[at + 1] == '"' || m_input[at + 1] == '\\')
+              i++;
+          } else if (static_cast<unsigned char>(c) < 0x20) {
+            return false;
+          }
+        }
+        if (close == m_size)
+          return false;
+
+        sink.String(markAt(pos), m_input + pos + 1, m_input + close,
+                    hasEscapes);
+        if (isKey) {
+          expect = Colon;
+          key = pos;
+          keyLine = line;
+        } else {
+          endValue();
+        }
+        text = close + 1;
+        break;
+      }
+      default:  // another control character, or a stray backslash
+        return false;
+    }
+  }
+
+  if (expect != Done)
+    return false;
+  sink.DocumentEnd();
+  return true;
+}
+
+template void IndexedDocParser::HandleDocument(EventHandler& eventHandler)
+    const;
+template void IndexedDocParser::HandleDocument(NodeBuilder& eventHandler)
+    const;
+}  // namespace YAML
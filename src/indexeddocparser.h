@@ -0,0 +1,61 @@
+#ifndef INDEXEDDOCPARSER_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define INDEXEDDOCPARSER_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+
+namespace YAML {
+class StructuralIndex;
+
+// IndexedDocParser
+// . The second stage of reading a document held in memory: it reads the
+//   document from a StructuralIndex of the input, going from one structural
+//   byte to the next, rather than one character at a time through Scanner.
+// . It only reads plain JSON: one object or array, with nothing but
+//   whitespace around it. Anything else, or anything the scanner might read
+//   differently (a key too long to be a simple key, a control character in
+//   a string, nesting deeper than maxDepth), fails IsPlainJson, and is left
+//   to Scanner and SingleDocParser. They give the same events, with the same
+//   marks, for anything that passes.
+class IndexedDocParser {
+ public:
+  IndexedDocParser(const char* input, std::size_t size,
+                   const StructuralIndex& index, std::size_t maxDepth);
+  IndexedDocParser(const IndexedDocParser&) = delete;
+  IndexedDocParser(IndexedDocParser&&) = delete;
+  IndexedDocParser& operator=(const IndexedDocParser&) = delete;
+  IndexedDocParser& operator=(IndexedDocParser&&) = delete;
+
+  // MayBeJson
+  // . Returns false if the input can't be plain JSON, by its first bytes,
+  //   so that indexing it would be wasted.
+  static bool MayBeJson(const char* input, std::size_t size);
+
+  // IsPlainJson
+  // . Checks the whole input, without emitting anything.
+  bool IsPlainJson() const;
+
+  // HandleDocument
+  // . Emits the document, which must have passed IsPlainJson. Instantiated
+  //   in indexeddocparser.cpp for EventHandler and NodeBuilder, as with
+  //   SingleDocParser.
+  template <typename Handler>
+  void HandleDocument(Handler& eventHandler) const;
+
+ private:
+  template <typename Sink>
+  bool Walk(Sink& sink) const;
+
+  const char* m_input;
+  std::size_t m_size;
+  const StructuralIndex& m_index;
+  std::size_t m_maxDepth;
+};
+}  // namespace YAML
+
+#endif  // INDEXEDDOCPARSER_H_62B23520_7C8E_11DE_8A39_0800200C9A66
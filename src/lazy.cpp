@@ -0,0 +1,492 @@
+#include "yaml-cpp/node/lazy.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <istream>
+
+#include "documentsplit.h"
+#include "nodebuilder.h"
+#include "spanbuffer.h"
+#include "yaml-cpp/depthguard.h"
+#include "yaml-cpp/exceptions.h"
+#include "yaml-cpp/node/convert.h"
+#include "yaml-cpp/node/detail/impl.h"
+#include "yaml-cpp/node/detail/memory.h"
+#include "yaml-cpp/node/impl.h"
+#include "yaml-cpp/null.h"
+#include "yaml-cpp/parser.h"
+
+namespace YAML {
+namespace {
+bool IsFlowIndicator(char ch) {
+  return ch == ',' || ch == '[' || ch == ']' || ch == '{' || ch == '}';
+}
+
+// SkimState
+// . The little of the scanner's state that a skim needs to tell where the
+//   entries of a block map start: whether a line is inside a quoted scalar,
+//   a flow collection or a block scalar, any of which may run over lines
+//   that would otherwise look like keys.
+// . When in doubt it gives up, and the text is parsed properly instead.
+class SkimState {
+ public:
+  SkimState() : m_quote(0), m_flowDepth(0), m_blockIndent(-1) {}
+
+  bool IsOpen() const { return m_quote != 0 || m_flowDepth > 0; }
+
+  // whether the line (with the given indentation) is in a block scalar
+  bool InBlockScalar(const char* line, const char* end, int indent) {
+    if (m_blockIndent < 0)
+      return false;
+    if (indent > m_blockIndent || IsEmptyLine(line, end))
+      return true;
+    m_blockIndent = -1;
+    return false;
+  }
+
+  // Scan
+  // . Follows the tokens from p to the end of the line, on a line with the
+  //   given indentation.
+  // . Returns false if it finds an alias, which may refer to a node outside
+  //   the text being skimmed, or anything it isn't sure of.
+  bool Scan(const char* p, const char* end, int indent, bool onKeyLine) {
+    bool atToken = true;  // whether a token may start here
+    bool afterBlank = true;
+    while (p < end) {
+      const char ch = *p;
+      if (m_quote) {
+        if (ch == '\\' && m_quote == '"') {
+          p += 2;
+          continue;
+        }
+        if (ch == m_quote) {
+          if (m_quote == '\'' && p + 1 < end && p[1] == '\'') {
+            p += 2;
+            continue;
+          }
+          m_quote = 0;
+          atToken = false;
+        }
+        p++;
+        continue;
+      }
+
+      if (ch == ' ' || ch == '\t' || ch == '\r') {
+        afterBlank = true;
+        p++;
+        continue;
+      }
+      if (ch == '#' && afterBlank)
+        return true;
+      afterBlank = false;
+
+      const bool beforeBlank = p + 1 == end || IsBlankOrBreak(p[1]);
+      if (atToken) {
+        switch (ch) {
+          case '"':
+          case '\'':
+            m_quote = ch;
+            p++;
+            continue;
+          case '*':
+            return false;
+          case '&':
+          case '!':
+            while (p < end && !IsBlankOrBreak(*p))
+              p++;
+            continue;
+          case '|':
+          case '>':
+            if (m_flowDepth > 0)
+              break;
+            // an explicit indentation would be relative to the parent's
+            for (p++; p < end && !IsBlankOrBreak(*p); p++) {
+              if (std::isdigit(static_cast<unsigned char>(*p)))
+                return false;
+            }
+            m_blockIndent = indent;
+            return true;
+          case '-':
+          case '?':
+          case ':':
+            if (!beforeBlank || (ch == '-' && m_flowDepth > 0))
+              break;
+            // a block entry or key can't follow a key on its own line
+            if (onKeyLine && m_flowDepth == 0)
+              return false;
+            p++;
+            continue;
+          default:
+            break;
+        }
+      }
+
+      if ((ch == '[' || ch == '{') && (atToken || m_flowDepth > 0)) {
+        m_flowDepth++;
+        atToken = true;
+      } else if (m_flowDepth > 0) {
+        if (ch == ']' || ch == '}') {
+          m_flowDepth--;
+          atToken = false;
+        } else {
+          atToken = ch == ',' ||
+                    (ch == ':' && (beforeBlank || IsFlowIndicator(p[1])));
+        }
+      } else if (ch == ':' && beforeBlank) {
+        if (onKeyLine)
+          return false;
+        atToken = true;
+      } else {
+        atToken = false;
+      }
+      p++;
+    }
+    return true;
+  }
+
+ private:
+  char m_quote;  // the quote the line is inside, if any
+  int m_flowDepth;
+  int m_blockIndent;  // of the line a block scalar started on, if in one
+};
+
+// ParseKey
+// . Reads a simple key, plain or quoted (without escapes), at the start of
+//   the line, followed by the ':' that ends it.
+// . Returns false if it's anything else, including a null (which isn't
+//   looked up by its text).
+bool ParseKey(const char* p, const char* end, std::string& key,
+              const char*& keyEnd, const char*& colon) {
+  key.clear();
+  if (*p == '"' || *p == '\'') {
+    const char quote = *p;
+    for (p++;; p++) {
+      if (p == end || (*p == '\\' && quote == '"'))
+        return false;
+      if (*p == quote) {
+        if (quote == '"' || p + 1 == end || p[1] != '\'')
+          break;
+        p++;
+      }
+      key += *p;
+    }
+    keyEnd = ++p;
+    while (p < end && (*p == ' ' || *p == '\t'))
+      p++;
+    if (p == end || *p != ':' || (p + 1 < end && !IsBlankOrBreak(p[1])))
+      return false;
+    colon = p;
+    return true;
+  }
+
+  if (std::strchr("-?:,[]{}#&*!|>%@`", *p))
+    return false;
+  for (const char* q = p; q < end; q++) {
+    if (*q == '#' && (q[-1] == ' ' || q[-1] == '\t'))
+      return false;
+    if (*q == ':' && (q + 1 == end || IsBlankOrBreak(q[1]))) {
+      keyEnd = q;
+      while (keyEnd[-1] == ' ' || keyEnd[-1] == '\t')
+        keyEnd--;
+      key.assign(p, keyEnd);
+      colon = q;
+      return !IsNullString(key);
+    }
+  }
+  return false;
+}
+
+bool IsBlockEntry(const char* p, const char* end) {
+  return *p == '-' && (p + 1 == end || IsBlankOrBreak(p[1]));
+}
+}  // namespace
+
+LazyDocument::LazyDocument(const char* input, std::size_t size)
+    : m_input(input), m_size(size), m_slots{} {
+  // the stream skips a byte order mark without counting it in its marks
+  if (m_size >= 3 && std::equal(m_input, m_input + 3, "\xEF\xBB\xBF")) {
+    m_input += 3;
+    m_size -= 3;
+  }
+  m_slots.emplace_back(0, Mark(), -1);
+  m_slots.back().end = m_size;
+}
+
+LazyDocument::LazyDocument(const char* input)
+    : LazyDocument(input, std::strlen(input)) {}
+
+LazyDocument::LazyDocument(const std::string& input)
+    : LazyDocument(input.data(), input.size()) {}
+
+LazyDocument::~LazyDocument() = default;
+
+// Skim
+// . Skims the slot, if it hasn't been, for the entries of a block map; if it
+//   isn't one (or the skim can't be sure), parses it instead.
+LazyDocument::Slot& LazyDocument::Skim(std::size_t slot) {
+  if (m_slots[slot].state != Slot::Unskimmed)
+    return m_slots[slot];
+
+  const std::size_t firstEntry = m_slots.size();
+  if (SkimMap(slot))
+    return m_slots[slot];
+  m_slots.erase(m_slots.begin() + firstEntry, m_slots.end());
+
+  Slot& skimmed = m_slots[slot];
+  if (slot == 0) {
+    skimmed.node = Parse(0, m_size, skimmed.mark);
+  } else {
+    // a value is parsed with its key, so that it's indented just as it is in
+    // place, and an empty one is a null at just the same mark
+    const Node entry = Parse(skimmed.keyMark.pos, skimmed.end, skimmed.keyMark);
+    for (auto pair : entry) {
+      skimmed.keyNode = pair.first;
+      skimmed.node = pair.second;
+    }
+  }
+  skimmed.state = Slot::Parsed;
+  skimmed.isBuilt = true;
+  return skimmed;
+}
+
+// SkimMap
+// . Looks for the keys of a block map in the slot's text, line by line, and
+//   adds a slot for each entry. The map's keys are the lines indented the
+//   same as the first, that aren't in a scalar or a flow collection, and
+//   aren't block sequence entries (which may be indented as far as the key
+//   they're the value of).
+// . Returns false if the text isn't a block map, or may not be.
+bool LazyDocument::SkimMap(std::size_t slot) {
+  if (slot == 0 && !IsUtf8(m_input, m_size))
+    return false;
+
+  const char* p = m_input + m_slots[slot].begin;
+  const char* end = m_input + m_slots[slot].end;
+  const int parentIndent = m_slots[slot].indent;
+  int line = m_slots[slot].mark.line;
+
+  // a map that's a value starts on the line after its key
+  if (slot != 0) {
+    const char* lineEnd = std::find(p, end, '\n');
+    if (!IsEmptyLine(p, lineEnd))
+      return false;
+    p = lineEnd == end ? end : lineEnd + 1;
+    line++;
+  }
+
+  const std::size_t firstEntry = m_slots.size();
+  SkimState state;
+  int indent = -1;
+  bool isStarted = false;
+  std::string key;
+  for (; p < end; line++) {
+    const char* lineEnd = std::find(p, end, '\n');
+    const char* next = lineEnd == end ? end : lineEnd + 1;
+    const char* content = p;
+    while (content < lineEnd && *content == ' ')
+      content++;
+    const int lineIndent = static_cast<int>(content - p);
+
+    const char* lineBegin = p;
+    p = next;
+    if (state.InBlockScalar(content, lineEnd, lineIndent))
+      continue;
+    if (state.IsOpen()) {
+      if (!state.Scan(content, lineEnd, lineIndent, false))
+        return false;
+      continue;
+    }
+    if (IsEmptyLine(content, lineEnd))
+      continue;
+
+    if (slot == 0 && lineIndent == 0) {
+      if (*content == '%')
+        return false;
+      const bool isStart = IsDocumentIndicator(content, lineEnd, '-');
+      if (isStart && indent < 0 && !isStarted &&
+          IsEmptyLine(content + 3, lineEnd)) {
+        isStarted = true;
+        continue;
+      }
+      if (isStart || IsDocumentIndicator(content, lineEnd, '.')) {
+        if (indent < 0)
+          return false;
+        end = lineBegin;
+        break;
+      }
+    }
+
+    if (*content == '\t')
+      return false;
+    if (indent < 0) {
+      if (lineIndent <= parentIndent)
+        return false;
+      indent = lineIndent;
+    }
+    if (lineIndent < indent)
+      return false;
+
+    if (lineIndent > indent || IsBlockEntry(content, lineEnd)) {
+      if (m_slots.size() == firstEntry ||
+          !state.Scan(content, lineEnd, lineIndent, false))
+        return false;
+      continue;
+    }
+
+    const char* keyEnd;
+    const char* colon;
+    if (!ParseKey(content, lineEnd, key, keyEnd, colon))
+      return false;
+
+    Mark keyMark;
+    keyMark.pos = static_cast<int>(content - m_input);
+    keyMark.line = line;
+    keyMark.column = lineIndent;
+    if (m_slots.size() > firstEntry)
+      m_slots.back().end = content - m_input;
+
+    Mark valueMark;
+    valueMark.pos = static_cast<int>(colon + 1 - m_input);
+    valueMark.line = line;
+    valueMark.column = static_cast<int>(colon + 1 - lineBegin);
+    m_slots.emplace_back(colon + 1 - m_input, valueMark, indent);
+    Slot& entry = m_slots.back();
+    entry.key = key;
+    entry.keyEnd = keyEnd - m_input;
+    entry.keyMark = keyMark;
+
+    if (!state.Scan(colon + 1, lineEnd, indent, true))
+      return false;
+  }
+
+  if (state.IsOpen() || m_slots.size() == firstEntry)
+    return false;
+
+  m_slots.back().end = end - m_input;
+
+  Slot& map = m_slots[slot];
+  map.end = end - m_input;
+  map.state = Slot::Map;
+  map.firstEntry = firstEntry;
+  map.entryCount = m_slots.size() - firstEntry;
+  return true;
+}
+
+// Find
+// . Returns the slot of the first entry with the key, or 0 if there's none.
+std::size_t LazyDocument::Find(std::size_t slot, const std::string& key) {
+  const Slot& map = Skim(slot);
+  for (std::size_t i = 0; i < map.entryCount; i++) {
+    if (m_slots[map.firstEntry + i].key == key)
+      return map.firstEntry + i;
+  }
+  return 0;
+}
+
+// Build
+// . Builds the slot's node, parsing whatever's under it that hasn't been.
+Node LazyDocument::Build(std::size_t slot) {
+  Skim(slot);
+  if (m_slots[slot].isBuilt)
+    return m_slots[slot].node;
+
+  // as the parser would, the map starts at its first key
+  const std::size_t firstEntry = m_slots[slot].firstEntry;
+  const std::size_t entryCount = m_slots[slot].entryCount;
+  Node map(NodeType::Map);
+  map.m_pNode->set_mark(m_slots[firstEntry].keyMark);
+  map.SetTag("?");
+  map.SetStyle(EmitterStyle::Block);
+  for (std::size_t i = firstEntry; i < firstEntry + entryCount; i++) {
+    const Node value = Build(i);
+    const Slot& entry = m_slots[i];
+    if (entry.state == Slot::Parsed) {
+      map.force_insert(entry.keyNode, value);
+    } else {
+      map.force_insert(Parse(entry.keyMark.pos, entry.keyEnd, entry.keyMark),
+                       value);
+    }
+  }
+
+  m_slots[slot].node = map;
+  m_slots[slot].isBuilt = true;
+  return map;
+}
+
+Node LazyDocument::Parse(std::size_t begin, std::size_t end,
+                         const Mark& origin) const {
+  SpanBuffer buffer(m_input, 0, m_input + begin, end - begin);
+  std::istream stream(&buffer);
+  Parser parser(stream);
+  NodeBuilder builder(origin);
+  try {
+    if (!builder.BuildNextDocument(parser))
+      return Node();
+  } catch (const DeepRecursion& e) {
+    throw DeepRecursion(e.depth(), FromOrigin(e.mark, origin), e.msg);
+  } catch (const ParserException& e) {
+    throw ParserException(FromOrigin(e.mark, origin), e.msg);
+  }
+  return builder.Root();
+}
+
+NodeType::value LazyNode::Type() const {
+  if (!m_pDocument)
+    return m_node.Type();
+  const LazyDocument::Slot& slot = m_pDocument->Skim(m_slot);
+  if (slot.state == LazyDocument::Slot::Map)
+    return NodeType::Map;
+  return slot.node.Type();
+}
+
+bool LazyNode::IsDefined() const {
+  if (!m_pDocument)
+    return m_node.IsDefined();
+  return m_pDocument->Skim(m_slot).state == LazyDocument::Slot::Map ||
+         m_pDocument->m_slots[m_slot].node.IsDefined();
+}
+
+Node LazyNode::node() const {
+  return m_pDocument ? m_pDocument->Build(m_slot) : m_node;
+}
+
+std::size_t LazyNode::size() const {
+  if (m_pDocument) {
+    const LazyDocument::Slot& slot = m_pDocument->Skim(m_slot);
+    if (slot.state == LazyDocument::Slot::Map)
+      return slot.entryCount;
+  }
+  return node().size();
+}
+
+LazyNode LazyNode::operator[](const std::string& key) const {
+  if (m_pDocument &&
+      m_pDocument->Skim(m_slot).state == LazyDocument::Slot::Map) {
+    const std::size_t entry = m_pDocument->Find(m_slot, key);
+    if (entry)
+      return LazyNode(m_pDocument, entry);
+    const Node missing(NodeType::Map);
+    return LazyNode(missing[key]);
+  }
+  const Node node = this->node();
+  return LazyNode(node[key]);
+}
+
+// a map may have integer keys, which are looked up by their text
+LazyNode LazyNode::operator[](std::size_t index) const {
+  if (m_pDocument &&
+      m_pDocument->Skim(m_slot).state == LazyDocument::Slot::Map)
+    return (*this)[std::to_string(index)];
+  const Node node = this->node();
+  return LazyNode(node[index]);
+}
+
+LazyNode LazyNode::operator[](int index) const {
+  if (m_pDocument &&
+      m_pDocument->Skim(m_slot).state == LazyDocument::Slot::Map)
+    return (*this)[std::to_string(index)];
+  const Node node = this->node();
+  return LazyNode(node[index]);
+}
+}  // namespace YAML
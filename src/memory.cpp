@@ -1,9 +1,36 @@
 #include "yaml-cpp/node/detail/memory.h"
+
+#include <algorithm>
+#include <unordered_set>
+#include <vector>
+
 #include "yaml-cpp/node/detail/node.h"  // IWYU pragma: keep
 #include "yaml-cpp/node/ptr.h"
 
 namespace YAML {
 namespace detail {
+namespace {
+using Reached = std::unordered_set<const node*>;
+
+// Reach
+// . Returns the nodes reachable from the roots, each before any it reaches.
+std::vector<node*> Reach(const std::vector<node*>& roots, Reached& reached) {
+  std::vector<node*> order;
+  std::vector<node*> stack(roots.rbegin(), roots.rend());
+  while (!stack.empty()) {
+    node* pNode = stack.back();
+    stack.pop_back();
+    if (!reached.insert(pNode).second)
+      continue;
+
+    order.push_back(pNode);
+    const std::size_t first = stack.size();
+    pNode->list_children(stack);
+    std::reverse(stack.begin() + first, stack.end());
+  }
+  return order;
+}
+}  // namespace
 
 void memory_holder::merge(memory_holder& rhs) {
   if (m_pMemory == rhs.m_pMemory)
@@ -13,8 +40,32 @@ void memory_holder::merge(memory_holder& rhs) {
   rhs.m_pMemory = m_pMemory;
 }
 
+std::size_t memory_holder::collect(double growth) {
+  if (!m_pMemory)
+    return 0;
+
+  const double collectedSize =
+      static_cast<double>(m_pMemory->collected_size());
+  if (growth > 0 && static_cast<double>(m_pMemory->size()) <=
+                        collectedSize + collectedSize * growth)
+    return 0;
+  return m_pMemory->collect();
+}
+
+const shared_memory_holder& memory_holder::invalid() {
+  static memory_holder holder{std::string()};
+  static const shared_memory_holder pHolder(shared_memory_holder(), &holder);
+  return pHolder;
+}
+
+shared_memory_holder memory_holder::invalid(const std::string& key) {
+  if (key.empty())
+    return invalid();
+  return std::make_shared<memory_holder>(key);
+}
+
 node& memory::create_node() {
-  shared_node pNode(new node);
+  shared_node pNode = std::make_shared<node>();
   m_nodes.insert(pNode);
   return *pNode;
 }
@@ -22,5 +73,39 @@ node& memory::create_node() {
 void memory::merge(const memory& rhs) {
   m_nodes.insert(rhs.m_nodes.begin(), rhs.m_nodes.end());
 }
+
+// collect
+// . The entries that were only looked up are pruned first, children before
+//   their parents, so that a chain of lookups goes all at once; what's
+//   reachable is then found again without them.
+std::size_t memory::collect() {
+  std::vector<node*> roots;
+  for (const shared_node& pNode : m_nodes) {
+    if (pNode->has_handles())
+      roots.push_back(pNode.get());
+  }
+
+  Reached reached;
+  const std::vector<node*> order = Reach(roots, reached);
+  for (auto it = order.rbegin(); it != order.rend(); ++it)
+    (*it)->prune();
+  reached.clear();
+  Reach(roots, reached);
+
+  Nodes survivors;
+  for (const shared_node& pNode : m_nodes) {
+    if (reached.count(pNode.get()) == 0)
+      continue;
+    pNode->remove_dependencies_if([&](const node* pDependency) {
+      return reached.count(pDependency) == 0;
+    });
+    survivors.insert(survivors.end(), pNode);
+  }
+
+  const std::size_t collected = m_nodes.size() - survivors.size();
+  m_nodes.swap(survivors);
+  m_collectedSize = m_nodes.size();
+  return collected;
+}
 }  // namespace detail
 }  // namespace YAML
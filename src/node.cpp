@@ -1,6 +1,7 @@
 #include "yaml-cpp/node/node.h"
 #include "nodebuilder.h"
 #include "nodeevents.h"
+#include "yaml-cpp/node/detail/memory.h"
 
 namespace YAML {
 Node Clone(const Node& node) {
@@ -9,4 +10,10 @@ Node Clone(const Node& node) {
   events.Emit(builder);
   return builder.Root();
 }
+
+std::size_t CollectGarbage(const Node& node, double growth) {
+  if (!node.m_pMemory)
+    return 0;
+  return node.m_pMemory->collect(growth);
+}
 }  // namespace YAML
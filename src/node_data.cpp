@@ -1,36 +1,81 @@
 #include <algorithm>
 #include <cassert>
 #include <iterator>
+#include <memory>
+#include <new>
 #include <sstream>
+#include <unordered_set>
 
 #include "yaml-cpp/exceptions.h"
 #include "yaml-cpp/node/detail/memory.h"
 #include "yaml-cpp/node/detail/node.h"  // IWYU pragma: keep
 #include "yaml-cpp/node/detail/node_data.h"
 #include "yaml-cpp/node/detail/node_iterator.h"
+#include "yaml-cpp/node/impl.h"
 #include "yaml-cpp/node/ptr.h"
 #include "yaml-cpp/node/type.h"
 
 namespace YAML {
 namespace detail {
-YAML_CPP_API std::atomic<size_t> node::m_amount{0};
-
 const std::string& node_data::empty_scalar() {
   static const std::string svalue;
   return svalue;
 }
 
 node_data::node_data()
-    : m_isDefined(false),
-      m_mark(Mark::null_mark()),
+    : m_mark(Mark::null_mark()),
+      m_isDefined(false),
       m_type(NodeType::Null),
-      m_tag{},
       m_style(EmitterStyle::Default),
-      m_scalar{},
-      m_sequence{},
-      m_seqSize(0),
-      m_map{},
-      m_undefinedPairs{} {}
+      m_cacheKind(0),
+      m_cache(0),
+      m_pTag{},
+      m_pSequence(nullptr) {}
+
+node_data::~node_data() { destroy_payload(); }
+
+void node_data::reset() {
+  destroy_payload();
+  m_mark = Mark::null_mark();
+  m_isDefined = false;
+  m_style = EmitterStyle::Default;
+  m_pTag.reset();
+  clear_cache();
+}
+
+void node_data::take(node_data& rhs) {
+  if (&rhs == this)
+    return;
+
+  reset();
+  m_mark = rhs.m_mark;
+  m_isDefined = rhs.m_isDefined;
+  m_style = rhs.m_style;
+  m_pTag.swap(rhs.m_pTag);
+
+  // the pointers are just handed over, so rhs mustn't delete them
+  const NodeType::value type = rhs.m_type;
+  switch (type) {
+    case NodeType::Scalar:
+      new (&m_scalar) std::string;
+      m_scalar.swap(rhs.m_scalar);
+      break;
+    case NodeType::Sequence:
+      m_pSequence = rhs.m_pSequence;
+      rhs.m_type = NodeType::Null;
+      break;
+    case NodeType::Map:
+      m_pMap = rhs.m_pMap;
+      rhs.m_type = NodeType::Null;
+      break;
+    case NodeType::Undefined:
+    case NodeType::Null:
+      break;
+  }
+  m_type = type;
+
+  rhs.reset();
+}
 
 void node_data::mark_defined() {
   if (m_type == NodeType::Undefined)
@@ -42,7 +87,7 @@ void node_data::set_mark(const Mark& mark) { m_mark = mark; }
 
 void node_data::set_type(NodeType::value type) {
   if (type == NodeType::Undefined) {
-    m_type = type;
+    set_payload(type);
     m_isDefined = false;
     return;
   }
@@ -51,39 +96,31 @@ void node_data::set_type(NodeType::value type) {
   if (type == m_type)
     return;
 
-  m_type = type;
+  set_payload(type);
+}
 
-  switch (m_type) {
-    case NodeType::Null:
-      break;
-    case NodeType::Scalar:
-      m_scalar.clear();
-      break;
-    case NodeType::Sequence:
-      reset_sequence();
-      break;
-    case NodeType::Map:
-      reset_map();
-      break;
-    case NodeType::Undefined:
-      assert(false);
-      break;
-  }
+void node_data::set_tag(const std::string& tag) {
+  if (tag.empty())
+    m_pTag.reset();
+  else
+    m_pTag = std::make_shared<const std::string>(tag);
 }
 
-void node_data::set_tag(const std::string& tag) { m_tag = tag; }
+void node_data::set_tag(const shared_tag& pTag) { m_pTag = pTag; }
 
 void node_data::set_style(EmitterStyle::value style) { m_style = style; }
 
 void node_data::set_null() {
   m_isDefined = true;
-  m_type = NodeType::Null;
+  set_payload(NodeType::Null);
 }
 
 void node_data::set_scalar(const std::string& scalar) {
   m_isDefined = true;
-  m_type = NodeType::Scalar;
+  if (m_type != NodeType::Scalar)
+    set_payload(NodeType::Scalar);
   m_scalar = scalar;
+  clear_cache();
 }
 
 // size/iterator
@@ -93,11 +130,13 @@ std::size_t node_data::size() const {
 
   switch (m_type) {
     case NodeType::Sequence:
+      if (m_pSequence->pPacked)
+        return m_pSequence->pPacked->size();
       compute_seq_size();
-      return m_seqSize;
+      return m_pSequence->size;
     case NodeType::Map:
       compute_map_size();
-      return m_map.size() - m_undefinedPairs.size();
+      return m_pMap->pairs.size() - m_pMap->undefinedPairs.size();
     default:
       return 0;
   }
@@ -105,16 +144,19 @@ std::size_t node_data::size() const {
 }
 
 void node_data::compute_seq_size() const {
-  while (m_seqSize < m_sequence.size() && m_sequence[m_seqSize]->is_defined())
-    m_seqSize++;
+  const node_seq& sequence = m_pSequence->nodes;
+  std::size_t& size = m_pSequence->size;
+  while (size < sequence.size() && sequence[size]->is_defined())
+    size++;
 }
 
 void node_data::compute_map_size() const {
-  auto it = m_undefinedPairs.begin();
-  while (it != m_undefinedPairs.end()) {
+  kv_pairs& undefinedPairs = m_pMap->undefinedPairs;
+  auto it = undefinedPairs.begin();
+  while (it != undefinedPairs.end()) {
     auto jt = std::next(it);
     if (it->first->is_defined() && it->second->is_defined())
-      m_undefinedPairs.erase(it);
+      undefinedPairs.erase(it);
     it = jt;
   }
 }
@@ -125,9 +167,10 @@ const_node_iterator node_data::begin() const {
 
   switch (m_type) {
     case NodeType::Sequence:
-      return const_node_iterator(m_sequence.begin());
+      assert(!m_pSequence->pPacked);
+      return const_node_iterator(m_pSequence->nodes.cbegin());
     case NodeType::Map:
-      return const_node_iterator(m_map.begin(), m_map.end());
+      return const_node_iterator(m_pMap->pairs.cbegin(), m_pMap->pairs.cend());
     default:
       return {};
   }
@@ -139,9 +182,10 @@ node_iterator node_data::begin() {
 
   switch (m_type) {
     case NodeType::Sequence:
-      return node_iterator(m_sequence.begin());
+      assert(!m_pSequence->pPacked);
+      return node_iterator(m_pSequence->nodes.begin());
     case NodeType::Map:
-      return node_iterator(m_map.begin(), m_map.end());
+      return node_iterator(m_pMap->pairs.begin(), m_pMap->pairs.end());
     default:
       return {};
   }
@@ -153,9 +197,10 @@ const_node_iterator node_data::end() const {
 
   switch (m_type) {
     case NodeType::Sequence:
-      return const_node_iterator(m_sequence.end());
+      assert(!m_pSequence->pPacked);
+      return const_node_iterator(m_pSequence->nodes.cend());
     case NodeType::Map:
-      return const_node_iterator(m_map.end(), m_map.end());
+      return const_node_iterator(m_pMap->pairs.cend(), m_pMap->pairs.cend());
     default:
       return {};
   }
@@ -167,26 +212,129 @@ node_iterator node_data::end() {
 
   switch (m_type) {
     case NodeType::Sequence:
-      return node_iterator(m_sequence.end());
+      assert(!m_pSequence->pPacked);
+      return node_iterator(m_pSequence->nodes.end());
     case NodeType::Map:
-      return node_iterator(m_map.end(), m_map.end());
+      return node_iterator(m_pMap->pairs.end(), m_pMap->pairs.end());
     default:
       return {};
   }
 }
 
-// sequence
-void node_data::push_back(node& node,
-                          const shared_memory_holder& /* pMemory */) {
-  if (m_type == NodeType::Undefined || m_type == NodeType::Null) {
-    m_type = NodeType::Sequence;
-    reset_sequence();
+// packed sequence
+bool node_data::append_packed(const std::string& text) {
+  if (m_type != NodeType::Sequence || !m_pSequence->nodes.empty())
+    return false;
+
+  if (!m_pSequence->pPacked)
+    m_pSequence->pPacked.reset(new packed_numbers);
+  return m_pSequence->pPacked->append(text);
+}
+
+namespace {
+const shared_tag& PlainTag() {
+  static const shared_tag pTag = std::make_shared<const std::string>("?");
+  return pTag;
+}
+}  // namespace
+
+// unpack
+// . Makes a node for each element, as a plain scalar. Their own marks aren't
+//   kept, so they're given the sequence's.
+void node_data::unpack(const shared_memory_holder& pMemory) {
+  if (m_type != NodeType::Sequence || !m_pSequence->pPacked)
+    return;
+
+  const packed_numbers& packed = *m_pSequence->pPacked;
+  const shared_tag& pTag = PlainTag();
+  node_seq nodes;
+  nodes.reserve(packed.size());
+  for (std::size_t i = 0; i < packed.size(); i++) {
+    node& element = pMemory->create_node();
+    element.set_mark(m_mark);
+    element.set_scalar(packed.text(i));
+    element.set_tag(pTag);
+    element.mark_attached();
+    nodes.push_back(&element);
+  }
+
+  m_pSequence->nodes.swap(nodes);
+  m_pSequence->pPacked.reset();
+}
+
+Node packed_access::element(const node& sequence, std::size_t index) {
+  shared_memory_holder pMemory(new memory_holder);
+  node& element = pMemory->create_node();
+  element.set_mark(sequence.mark());
+  element.set_scalar(sequence.packed()->text(index));
+  element.set_tag(PlainTag());
+  return Node(element, pMemory);
+}
+
+// garbage collection
+namespace {
+bool IsOnlyLookedUp(const node& value) {
+  // a lookup into it converts it, which it remembers
+  return !value.is_defined() && !value.has_handles() && !value.is_shared() &&
+         !value.has_payload();
+}
+
+bool IsUnreferenced(const node& key) {
+  return !key.has_handles() && !key.is_shared();
+}
+}  // namespace
+
+void node_data::prune() {
+  // a sequence's undefined elements are still iterated over, and pushed
+  // after, so only a map has any to drop
+  if (m_type != NodeType::Map)
+    return;
+
+  compute_map_size();
+  kv_pairs& undefinedPairs = m_pMap->undefinedPairs;
+  std::unordered_set<const node*> pruned;
+  for (auto it = undefinedPairs.begin(); it != undefinedPairs.end();) {
+    if (IsOnlyLookedUp(*it->second) && IsUnreferenced(*it->first)) {
+      pruned.insert(it->second);
+      it = undefinedPairs.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  if (pruned.empty())
+    return;
+
+  node_map& pairs = m_pMap->pairs;
+  pairs.erase(std::remove_if(pairs.begin(), pairs.end(),
+                             [&](const kv_pair& pair) {
+                               return pruned.count(pair.second) > 0;
+                             }),
+              pairs.end());
+}
+
+void node_data::list_children(std::vector<node*>& children) const {
+  if (m_type == NodeType::Sequence) {
+    const node_seq& nodes = m_pSequence->nodes;
+    children.insert(children.end(), nodes.begin(), nodes.end());
+  } else if (m_type == NodeType::Map) {
+    for (const kv_pair& pair : m_pMap->pairs) {
+      children.push_back(pair.first);
+      children.push_back(pair.second);
+    }
   }
+}
+
+// sequence
+void node_data::push_back(node& node, const shared_memory_holder& pMemory) {
+  if (m_type == NodeType::Undefined || m_type == NodeType::Null)
+    set_payload(NodeType::Sequence);
 
   if (m_type != NodeType::Sequence)
     throw BadPushback();
 
-  m_sequence.push_back(&node);
+  unpack(pMemory);
+  node.mark_attached();
+  m_pSequence->nodes.push_back(&node);
 }
 
 void node_data::insert(node& key, node& value,
@@ -213,7 +361,7 @@ node* node_data::get(node& key,
     return nullptr;
   }
 
-  for (const auto& it : m_map) {
+  for (const auto& it : m_pMap->pairs) {
     if (it.first->is(key))
       return it.second;
   }
@@ -234,7 +382,7 @@ node& node_data::get(node& key, const shared_memory_holder& pMemory) {
       throw BadSubscript(m_mark, key);
   }
 
-  for (const auto& it : m_map) {
+  for (const auto& it : m_pMap->pairs) {
     if (it.first->is(key))
       return *it.second;
   }
@@ -248,50 +396,89 @@ bool node_data::remove(node& key, const shared_memory_holder& /* pMemory */) {
   if (m_type != NodeType::Map)
     return false;
 
-  for (auto it = m_undefinedPairs.begin(); it != m_undefinedPairs.end();) {
+  kv_pairs& undefinedPairs = m_pMap->undefinedPairs;
+  for (auto it = undefinedPairs.begin(); it != undefinedPairs.end();) {
     auto jt = std::next(it);
     if (it->first->is(key))
-      m_undefinedPairs.erase(it);
+      undefinedPairs.erase(it);
     it = jt;
   }
 
+  node_map& pairs = m_pMap->pairs;
   auto it =
-      std::find_if(m_map.begin(), m_map.end(),
+      std::find_if(pairs.begin(), pairs.end(),
                    [&](std::pair<YAML::detail::node*, YAML::detail::node*> j) {
                      return (j.first->is(key));
                    });
 
-  if (it != m_map.end()) {
-    m_map.erase(it);
+  if (it != pairs.end()) {
+    pairs.erase(it);
     return true;
   }
 
   return false;
 }
 
-void node_data::reset_sequence() {
-  m_sequence.clear();
-  m_seqSize = 0;
+// set_payload
+// . Changes the node's type, replacing its payload with an empty one for the
+//   new type.
+void node_data::set_payload(NodeType::value type) {
+  destroy_payload();
+  clear_cache();
+
+  switch (type) {
+    case NodeType::Scalar:
+      new (&m_scalar) std::string;
+      break;
+    case NodeType::Sequence:
+      m_pSequence = new sequence_data;
+      break;
+    case NodeType::Map:
+      m_pMap = new map_data;
+      break;
+    case NodeType::Undefined:
+    case NodeType::Null:
+      break;
+  }
+  m_type = type;
 }
 
-void node_data::reset_map() {
-  m_map.clear();
-  m_undefinedPairs.clear();
+void node_data::destroy_payload() {
+  switch (m_type) {
+    case NodeType::Scalar:
+      m_scalar.~basic_string();
+      break;
+    case NodeType::Sequence:
+      delete m_pSequence;
+      break;
+    case NodeType::Map:
+      delete m_pMap;
+      break;
+    case NodeType::Undefined:
+    case NodeType::Null:
+      break;
+  }
+  m_type = NodeType::Null;
 }
 
 void node_data::insert_map_pair(node& key, node& value) {
-  m_map.emplace_back(&key, &value);
+  key.mark_attached();
+  value.mark_attached();
+  add_map_pair(key, value);
+}
+
+void node_data::add_map_pair(node& key, node& value) {
+  m_pMap->pairs.emplace_back(&key, &value);
 
   if (!key.is_defined() || !value.is_defined())
-    m_undefinedPairs.emplace_back(&key, &value);
+    m_pMap->undefinedPairs.emplace_back(&key, &value);
 }
 
 void node_data::convert_to_map(const shared_memory_holder& pMemory) {
   switch (m_type) {
     case NodeType::Undefined:
     case NodeType::Null:
-      reset_map();
-      m_type = NodeType::Map;
+      set_payload(NodeType::Map);
       break;
     case NodeType::Sequence:
       convert_sequence_to_map(pMemory);
@@ -306,19 +493,24 @@ void node_data::convert_to_map(const shared_memory_holder& pMemory) {
 
 void node_data::convert_sequence_to_map(const shared_memory_holder& pMemory) {
   assert(m_type == NodeType::Sequence);
+  unpack(pMemory);
 
-  reset_map();
-  for (std::size_t i = 0; i < m_sequence.size(); i++) {
+  // the sequence is detached first, so that the map can take its place
+  std::unique_ptr<sequence_data> pSequence(m_pSequence);
+  m_type = NodeType::Null;
+  set_payload(NodeType::Map);
+
+  const node_seq& sequence = pSequence->nodes;
+  for (std::size_t i = 0; i < sequence.size(); i++) {
     std::stringstream stream;
     stream << i;
 
     node& key = pMemory->create_node();
     key.set_scalar(stream.str());
-    insert_map_pair(key, *m_sequence[i]);
+    key.mark_attached();
+    // the value just moves from the sequence, so it isn't attached again
+    add_map_pair(key, *sequence[i]);
   }
-
-  reset_sequence();
-  m_type = NodeType::Map;
 }
 }  // namespace detail
 }  // namespace YAML
@@ -5,17 +5,23 @@
 #include "yaml-cpp/node/impl.h"
 #include "yaml-cpp/node/node.h"
 #include "yaml-cpp/node/type.h"
+#include "yaml-cpp/parser.h"
 
 namespace YAML {
-struct Mark;
+NodeBuilder::NodeBuilder() : NodeBuilder(Mark()) {}
 
-NodeBuilder::NodeBuilder()
+NodeBuilder::NodeBuilder(const Mark& origin)
     : m_pMemory(new detail::memory_holder),
       m_pRoot(nullptr),
       m_stack{},
       m_anchors{},
       m_keys{},
-      m_mapDepth(0) {
+      m_mapDepth(0),
+      m_origin(origin),
+      m_isPacking(false),
+      m_packedMarks{},
+      m_tags{},
+      m_pLastTag(nullptr) {
   m_anchors.push_back(nullptr);  // since the anchors start at 1
 }
 
@@ -28,6 +34,10 @@ Node NodeBuilder::Root() {
   return Node(*m_pRoot, m_pMemory);
 }
 
+bool NodeBuilder::BuildNextDocument(Parser& parser) {
+  return parser.ParseNextDocument(*this);
+}
+
 void NodeBuilder::OnDocumentStart(const Mark&) {}
 
 void NodeBuilder::OnDocumentEnd() {}
@@ -46,27 +56,33 @@ void NodeBuilder::OnAlias(const Mark& /* mark */, anchor_t anchor) {
 
 void NodeBuilder::OnScalar(const Mark& mark, const std::string& tag,
                            anchor_t anchor, const std::string& value) {
+  if (m_isPacking && AppendPacked(mark, tag, anchor, value))
+    return;
+
   detail::node& node = Push(mark, anchor);
   node.set_scalar(value);
-  node.set_tag(tag);
+  node.set_tag(InternTag(tag));
   Pop();
 }
 
 void NodeBuilder::OnSequenceStart(const Mark& mark, const std::string& tag,
                                   anchor_t anchor, EmitterStyle::value style) {
   detail::node& node = Push(mark, anchor);
-  node.set_tag(tag);
+  node.set_tag(InternTag(tag));
   node.set_type(NodeType::Sequence);
   node.set_style(style);
 }
 
-void NodeBuilder::OnSequenceEnd() { Pop(); }
+void NodeBuilder::OnSequenceEnd() {
+  m_packedMarks.clear();
+  Pop();
+}
 
 void NodeBuilder::OnMapStart(const Mark& mark, const std::string& tag,
                              anchor_t anchor, EmitterStyle::value style) {
   detail::node& node = Push(mark, anchor);
   node.set_type(NodeType::Map);
-  node.set_tag(tag);
+  node.set_tag(InternTag(tag));
   node.set_style(style);
   m_mapDepth++;
 }
@@ -79,13 +95,16 @@ void NodeBuilder::OnMapEnd() {
 
 detail::node& NodeBuilder::Push(const Mark& mark, anchor_t anchor) {
   detail::node& node = m_pMemory->create_node();
-  node.set_mark(mark);
+  node.set_mark(FromOrigin(mark, m_origin));
   RegisterAnchor(anchor, node);
   Push(node);
   return node;
 }
 
 void NodeBuilder::Push(detail::node& node) {
+  if (m_isPacking)
+    UnpackTop();
+
   const bool needsKey =
       (!m_stack.empty() && m_stack.back()->type() == NodeType::Map &&
        m_keys.size() < m_mapDepth);
@@ -125,10 +144,68 @@ void NodeBuilder::Pop() {
   }
 }
 
+Mark FromOrigin(const Mark& mark, const Mark& origin) {
+  if (mark.is_null())
+    return mark;
+
+  Mark shifted = mark;
+  shifted.pos += origin.pos;
+  if (shifted.line == 0)
+    shifted.column += origin.column;
+  shifted.line += origin.line;
+  return shifted;
+}
+
 void NodeBuilder::RegisterAnchor(anchor_t anchor, detail::node& node) {
   if (anchor) {
     assert(anchor == m_anchors.size());
     m_anchors.push_back(&node);
   }
 }
+
+// AppendPacked
+// . Packs a plain number into the sequence on top of the stack, if it's
+//   still packed (or empty).
+bool NodeBuilder::AppendPacked(const Mark& mark, const std::string& tag,
+                               anchor_t anchor, const std::string& value) {
+  if (m_stack.empty() || anchor != NullAnchor || tag != "?")
+    return false;
+
+  detail::node& sequence = *m_stack.back();
+  if (!sequence.append_packed(value))
+    return false;
+
+  m_packedMarks.push_back(mark);
+  return true;
+}
+
+// UnpackTop
+// . Unpacks the sequence on top of the stack before anything but a packed
+//   number goes into it, and gives its elements back their marks.
+void NodeBuilder::UnpackTop() {
+  if (m_stack.empty() || !m_stack.back()->packed())
+    return;
+
+  detail::node& sequence = *m_stack.back();
+  sequence.unpack(m_pMemory);
+  std::size_t i = 0;
+  for (auto element : sequence)
+    (*element).set_mark(FromOrigin(m_packedMarks[i++], m_origin));
+  m_packedMarks.clear();
+}
+
+// InternTag
+// . Returns the one copy of the tag that the nodes built share. A run of
+//   nodes with the same tag is common enough that the last tag is checked
+//   first.
+const detail::shared_tag& NodeBuilder::InternTag(const std::string& tag) {
+  if (m_pLastTag && **m_pLastTag == tag)
+    return *m_pLastTag;
+
+  detail::shared_tag& pTag = m_tags[tag];
+  if (!pTag)
+    pTag = std::make_shared<const std::string>(tag);
+  m_pLastTag = &pTag;
+  return pTag;
+}
 }  // namespace YAML
@@ -7,26 +7,32 @@
 #pragma once
 #endif
 
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "yaml-cpp/anchor.h"
 #include "yaml-cpp/emitterstyle.h"
 #include "yaml-cpp/eventhandler.h"
+#include "yaml-cpp/mark.h"
 #include "yaml-cpp/node/ptr.h"
 
 namespace YAML {
 namespace detail {
 class node;
 }  // namespace detail
-struct Mark;
 }  // namespace YAML
 
 namespace YAML {
 class Node;
+class Parser;
 
-class NodeBuilder : public EventHandler {
+class NodeBuilder final : public EventHandler {
  public:
   NodeBuilder();
+  // for input that starts at origin in some larger stream, which the marks
+  // of the nodes built are then relative to
+  explicit NodeBuilder(const Mark& origin);
   NodeBuilder(const NodeBuilder&) = delete;
   NodeBuilder(NodeBuilder&&) = delete;
   NodeBuilder& operator=(const NodeBuilder&) = delete;
@@ -35,6 +41,17 @@ class NodeBuilder : public EventHandler {
 
   Node Root();
 
+  // EnablePacking
+  // . Keeps a sequence whose elements are all plain numbers packed (see
+  //   detail::packed_numbers) rather than as nodes.
+  void EnablePacking() { m_isPacking = true; }
+
+  // BuildNextDocument
+  // . Builds the parser's next document, with the events dispatched straight
+  //   to this builder rather than through EventHandler.
+  // . Returns false if there are no more documents.
+  bool BuildNextDocument(Parser& parser);
+
   void OnDocumentStart(const Mark& mark) override;
   void OnDocumentEnd() override;
 
@@ -56,6 +73,10 @@ class NodeBuilder : public EventHandler {
   void Push(detail::node& node);
   void Pop();
   void RegisterAnchor(anchor_t anchor, detail::node& node);
+  bool AppendPacked(const Mark& mark, const std::string& tag,
+                    anchor_t anchor, const std::string& value);
+  void UnpackTop();
+  const detail::shared_tag& InternTag(const std::string& tag);
 
  private:
   detail::shared_memory_holder m_pMemory;
@@ -68,7 +89,23 @@ class NodeBuilder : public EventHandler {
   using PushedKey = std::pair<detail::node*, bool>;
   std::vector<PushedKey> m_keys;
   std::size_t m_mapDepth;
+  Mark m_origin;
+
+  // while packing, the sequence on top of the stack may be packed; the
+  // marks of its elements are kept in case it has to be unpacked after all
+  bool m_isPacking;
+  std::vector<Mark> m_packedMarks;
+
+  // every tag the nodes built have, so that the nodes with the same tag can
+  // share it
+  std::unordered_map<std::string, detail::shared_tag> m_tags;
+  const detail::shared_tag* m_pLastTag;
 };
+
+// FromOrigin
+// . Converts a mark in input that starts at origin in some larger stream to
+//   a mark in that stream.
+Mark FromOrigin(const Mark& mark, const Mark& origin);
 }  // namespace YAML
 
 #endif  // NODE_NODEBUILDER_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -20,18 +20,25 @@ anchor_t NodeEvents::AliasManager::LookupAnchor(
 }
 
 NodeEvents::NodeEvents(const Node& node)
-    : m_pMemory(node.m_pMemory), m_root(node.m_pNode), m_refCount{} {
-  if (m_root)
-    Setup(*m_root);
-}
+    : m_pMemory(node.m_pMemory),
+      m_root(node.m_pNode),
+      m_refCount{},
+      m_isSetup(false) {}
 
+// Setup
+// . Counts how often each node that may be aliased is reached. A node that
+//   was never shared is reached exactly once, so it is walked but not counted.
 void NodeEvents::Setup(const detail::node& node) {
-  int& refCount = m_refCount[node.ref()];
-  refCount++;
-  if (refCount > 1)
-    return;
+  if (MayBeAliased(node)) {
+    int& refCount = m_refCount[node.ref()];
+    refCount++;
+    if (refCount > 1)
+      return;
+  }
 
   if (node.type() == NodeType::Sequence) {
+    if (node.packed())
+      return;  // its elements aren't nodes, so can't be aliased
     for (auto element : node)
       Setup(*element);
   } else if (node.type() == NodeType::Map) {
@@ -52,7 +59,7 @@ void NodeEvents::Emit(EventHandler& handler) {
 }
 
 void NodeEvents::Emit(const detail::node& node, EventHandler& handler,
-                      AliasManager& am) const {
+                      AliasManager& am) {
   anchor_t anchor = NullAnchor;
   if (IsAliased(node)) {
     anchor = am.LookupAnchor(node);
@@ -76,8 +83,13 @@ void NodeEvents::Emit(const detail::node& node, EventHandler& handler,
       break;
     case NodeType::Sequence:
       handler.OnSequenceStart(Mark(), node.tag(), anchor, node.style());
-      for (auto element : node)
-        Emit(*element, handler, am);
+      if (const detail::packed_numbers* pPacked = node.packed()) {
+        for (std::size_t i = 0; i < pPacked->size(); i++)
+          handler.OnScalar(Mark(), "?", NullAnchor, pPacked->text(i));
+      } else {
+        for (auto element : node)
+          Emit(*element, handler, am);
+      }
       handler.OnSequenceEnd();
       break;
     case NodeType::Map:
@@ -91,7 +103,24 @@ void NodeEvents::Emit(const detail::node& node, EventHandler& handler,
   }
 }
 
-bool NodeEvents::IsAliased(const detail::node& node) const {
+// MayBeAliased
+// . The root can be reached again only through a cycle, which requires it to
+//   be attached to a collection somewhere
+bool NodeEvents::MayBeAliased(const detail::node& node) const {
+  return node.is_shared() || (&node == m_root && node.is_attached());
+}
+
+bool NodeEvents::IsAliased(const detail::node& node) {
+  if (!MayBeAliased(node))
+    return false;
+
+  // the whole tree is counted lazily, the first time it matters; a tree
+  // without shared nodes is thus emitted in a single traversal
+  if (!m_isSetup) {
+    Setup(*m_root);
+    m_isSetup = true;
+  }
+
   auto it = m_refCount.find(node.ref());
   return it != m_refCount.end() && it->second > 1;
 }
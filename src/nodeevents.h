@@ -7,8 +7,7 @@
 #pragma once
 #endif
 
-#include <map>
-#include <vector>
+#include <unordered_map>
 
 #include "yaml-cpp/anchor.h"
 #include "yaml-cpp/node/ptr.h"
@@ -45,7 +44,8 @@ class NodeEvents {
     anchor_t _CreateNewAnchor() { return ++m_curAnchor; }
 
    private:
-    using AnchorByIdentity = std::map<const detail::node_ref*, anchor_t>;
+    using AnchorByIdentity =
+        std::unordered_map<const detail::node_ref*, anchor_t>;
     AnchorByIdentity m_anchorByIdentity;
 
     anchor_t m_curAnchor;
@@ -53,15 +53,19 @@ class NodeEvents {
 
   void Setup(const detail::node& node);
   void Emit(const detail::node& node, EventHandler& handler,
-            AliasManager& am) const;
-  bool IsAliased(const detail::node& node) const;
+            AliasManager& am);
+  bool MayBeAliased(const detail::node& node) const;
+  bool IsAliased(const detail::node& node);
 
  private:
   detail::shared_memory_holder m_pMemory;
   detail::node* m_root;
 
-  using RefCount = std::map<const detail::node_ref*, int>;
+  // only nodes that may be aliased are counted, and only once one of them
+  // is actually reached
+  using RefCount = std::unordered_map<const detail::node_ref*, int>;
   RefCount m_refCount;
+  bool m_isSetup;
 };
 }  // namespace YAML
 
@@ -0,0 +1,259 @@
+#include "nodeselector.h"
+
+#include "nodebuilder.h"
+#include "yaml-cpp/eventcursor.h"
+#include "yaml-cpp/exceptions.h"
+
+namespace YAML {
+NodeSelector::NodeSelector(EventCursor& cursor, NodeBuilder& builder,
+                           const std::vector<std::string>& paths)
+    : m_cursor(cursor),
+      m_builder(builder),
+      m_paths{},
+      m_anchors{},
+      m_curAnchor(0) {
+  m_paths.reserve(paths.size());
+  for (const std::string& path : paths)
+    m_paths.push_back(ParsePath(path));
+}
+
+NodeSelector::~NodeSelector() = default;
+
+bool NodeSelector::SelectDocument() {
+  const Event& start = m_cursor.next();
+  if (start.type == Event::Type::StreamEnd)
+    return false;
+
+  m_builder.OnDocumentStart(start.mark);
+
+  Matches paths(m_paths.size());
+  for (std::size_t i = 0; i < paths.size(); i++)
+    paths[i] = i;
+  SelectNode(m_cursor.next(), paths, 0);
+
+  // the root node has been read in full, so this is the document end
+  m_builder.OnDocumentEnd();
+  m_cursor.next();
+  return true;
+}
+
+// ParsePath
+// . Splits a path like "$.spec.items[0].name" into its keys. The leading "$"
+//   is optional, "*" (or "[*]") matches any key or index, and an empty path
+//   selects the whole document.
+NodeSelector::Path NodeSelector::ParsePath(const std::string& path) {
+  Path keys;
+  std::size_t i = (!path.empty() && path[0] == '$' ? 1 : 0);
+  while (i < path.size()) {
+    if (path[i] == '[') {
+      const std::size_t close = path.find(']', i);
+      if (close == std::string::npos || close == i + 1)
+        throw BadPath(path);
+      keys.push_back(path.substr(i + 1, close - i - 1));
+      i = close + 1;
+      continue;
+    }
+
+    // every key but the first (or a bracketed one) follows a '.'
+    if (path[i] == '.')
+      i++;
+    else if (!keys.empty() || i > 0)
+      throw BadPath(path);
+
+    const std::size_t end = path.find_first_of(".[", i);
+    const std::size_t length =
+        (end == std::string::npos ? path.size() : end) - i;
+    if (length == 0)
+      throw BadPath(path);
+    keys.push_back(path.substr(i, length));
+    i += length;
+  }
+  return keys;
+}
+
+// Match
+// . Returns the paths that continue past this level through the given key.
+NodeSelector::Matches NodeSelector::Match(const Matches& paths,
+                                          std::size_t level,
+                                          const std::string& key) const {
+  Matches matches;
+  for (std::size_t path : paths) {
+    const std::string& pathKey = m_paths[path][level];
+    if (pathKey == "*" || pathKey == key)
+      matches.push_back(path);
+  }
+  return matches;
+}
+
+// Ends
+// . Returns true if any of the paths selects the whole node at this level.
+bool NodeSelector::Ends(const Matches& paths, std::size_t level) const {
+  for (std::size_t path : paths) {
+    if (m_paths[path].size() == level)
+      return true;
+  }
+  return false;
+}
+
+// SelectNode
+// . Builds the parts of the node starting with this event that the paths
+//   select, reading the rest of it from the cursor.
+// . Only descends as deep as the longest path; anything under a selected
+//   node is copied without looking at it again.
+void NodeSelector::SelectNode(const Event& event, const Matches& paths,
+                              std::size_t level) {
+  if (Ends(paths, level)) {
+    Copy(event);
+    return;
+  }
+
+  // with no paths at all, not even the root is built
+  if (paths.empty()) {
+    m_cursor.skip();
+    return;
+  }
+
+  switch (event.type) {
+    case Event::Type::SequenceStart:
+      Forward(event);
+      SelectSequence(paths, level);
+      break;
+    case Event::Type::MapStart:
+      Forward(event);
+      SelectMap(paths, level);
+      break;
+    default:
+      // a scalar can't contain anything deeper
+      break;
+  }
+}
+
+void NodeSelector::SelectSequence(const Matches& paths, std::size_t level) {
+  std::size_t index = 0;
+  std::size_t built = 0;
+  while (true) {
+    const Event& entry = m_cursor.next();
+    if (entry.type == Event::Type::SequenceEnd) {
+      Forward(entry);
+      return;
+    }
+
+    const Matches matches = Match(paths, level, std::to_string(index));
+    const bool isCollection = entry.type == Event::Type::SequenceStart ||
+                              entry.type == Event::Type::MapStart;
+    if (!matches.empty() && (isCollection || Ends(matches, level + 1))) {
+      // pad out the entries skipped before this one, so it keeps its index
+      for (; built < index; built++)
+        m_builder.OnNull(entry.mark, NullAnchor);
+      SelectNode(entry, matches, level + 1);
+      built++;
+    } else {
+      m_cursor.skip();
+    }
+    index++;
+  }
+}
+
+void NodeSelector::SelectMap(const Matches& paths, std::size_t level) {
+  while (true) {
+    const Event& keyEvent = m_cursor.next();
+    if (keyEvent.type == Event::Type::MapEnd) {
+      Forward(keyEvent);
+      return;
+    }
+
+    // only scalar keys can be named in a path
+    Matches matches;
+    if (keyEvent.type == Event::Type::Scalar)
+      matches = Match(paths, level, keyEvent.value);
+    else
+      m_cursor.skip();
+
+    if (matches.empty()) {
+      m_cursor.next();
+      m_cursor.skip();
+      continue;
+    }
+
+    const Event key = keyEvent;
+    const Event& value = m_cursor.next();
+    const bool isCollection = value.type == Event::Type::SequenceStart ||
+                              value.type == Event::Type::MapStart;
+    if (isCollection || Ends(matches, level + 1)) {
+      Forward(key);
+      SelectNode(value, matches, level + 1);
+    } else {
+      m_cursor.skip();
+    }
+  }
+}
+
+// Copy
+// . Builds the node starting with this event in full.
+void NodeSelector::Copy(const Event& event) {
+  Forward(event);
+
+  std::size_t depth = 0;
+  Event::Type::value type = event.type;
+  while (true) {
+    if (type == Event::Type::SequenceStart || type == Event::Type::MapStart)
+      depth++;
+    else if (type == Event::Type::SequenceEnd || type == Event::Type::MapEnd)
+      depth--;
+    if (depth == 0)
+      return;
+
+    const Event& next = m_cursor.next();
+    Forward(next);
+    type = next.type;
+  }
+}
+
+void NodeSelector::Forward(const Event& event) {
+  switch (event.type) {
+    case Event::Type::Null:
+      m_builder.OnNull(event.mark, RegisterAnchor(event.anchor));
+      break;
+    case Event::Type::Alias: {
+      // the anchored node may have been skipped
+      const anchor_t anchor =
+          (event.anchor < m_anchors.size() ? m_anchors[event.anchor]
+                                           : NullAnchor);
+      if (anchor)
+        m_builder.OnAlias(event.mark, anchor);
+      else
+        m_builder.OnNull(event.mark, NullAnchor);
+      break;
+    }
+    case Event::Type::Scalar:
+      m_builder.OnScalar(event.mark, event.tag, RegisterAnchor(event.anchor),
+                         event.value);
+      break;
+    case Event::Type::SequenceStart:
+      m_builder.OnSequenceStart(event.mark, event.tag,
+                                RegisterAnchor(event.anchor), event.style);
+      break;
+    case Event::Type::SequenceEnd:
+      m_builder.OnSequenceEnd();
+      break;
+    case Event::Type::MapStart:
+      m_builder.OnMapStart(event.mark, event.tag,
+                           RegisterAnchor(event.anchor), event.style);
+      break;
+    case Event::Type::MapEnd:
+      m_builder.OnMapEnd();
+      break;
+    default:
+      break;
+  }
+}
+
+anchor_t NodeSelector::RegisterAnchor(anchor_t anchor) {
+  if (!anchor)
+    return NullAnchor;
+
+  if (anchor >= m_anchors.size())
+    m_anchors.resize(anchor + 1, NullAnchor);
+  return m_anchors[anchor] = ++m_curAnchor;
+}
+}  // namespace YAML
@@ -0,0 +1,67 @@
+#ifndef NODESELECTOR_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define NODESELECTOR_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+#include "yaml-cpp/anchor.h"
+
+namespace YAML {
+class EventCursor;
+class NodeBuilder;
+struct Event;
+
+// Builds only the parts of a document that a set of paths select, reading
+// its events from a cursor and skipping everything else unbuilt.
+class NodeSelector {
+ public:
+  NodeSelector(EventCursor& cursor, NodeBuilder& builder,
+               const std::vector<std::string>& paths);
+  NodeSelector(const NodeSelector&) = delete;
+  NodeSelector(NodeSelector&&) = delete;
+  NodeSelector& operator=(const NodeSelector&) = delete;
+  NodeSelector& operator=(NodeSelector&&) = delete;
+  ~NodeSelector();
+
+  // SelectDocument
+  // . Builds the selected parts of the cursor's next document.
+  // . Returns false if there are no more documents.
+  bool SelectDocument();
+
+ private:
+  using Path = std::vector<std::string>;
+  using Matches = std::vector<std::size_t>;
+
+  static Path ParsePath(const std::string& path);
+  Matches Match(const Matches& paths, std::size_t level,
+                const std::string& key) const;
+  bool Ends(const Matches& paths, std::size_t level) const;
+
+  void SelectNode(const Event& event, const Matches& paths,
+                  std::size_t level);
+  void SelectSequence(const Matches& paths, std::size_t level);
+  void SelectMap(const Matches& paths, std::size_t level);
+  void Copy(const Event& event);
+  void Forward(const Event& event);
+  anchor_t RegisterAnchor(anchor_t anchor);
+
+ private:
+  EventCursor& m_cursor;
+  NodeBuilder& m_builder;
+  std::vector<Path> m_paths;
+
+  // the builder's anchor for each anchor the parser assigned, or NullAnchor
+  // if that node was skipped; the builder needs them numbered densely
+  std::vector<anchor_t> m_anchors;
+  anchor_t m_curAnchor;
+};
+}  // namespace YAML
+
+#endif  // NODESELECTOR_H_62B23520_7C8E_11DE_8A39_0800200C9A66
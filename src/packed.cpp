@@ -0,0 +1,145 @@
+#include "yaml-cpp/node/detail/packed.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <limits>
+
+namespace YAML {
+namespace detail {
+namespace {
+bool IsDigit(char ch) { return ch >= '0' && ch <= '9'; }
+
+// ParseInteger
+// . Only canonical decimal integers, -?(0|[1-9][0-9]*), but not -0: they're
+//   the ones whose text can be told from their value, and they convert to
+//   every integer type the same way (a leading 0 would make one octal).
+bool ParseInteger(const std::string& text, std::int64_t& value) {
+  const bool isNegative = !text.empty() && text[0] == '-';
+  const std::size_t begin = isNegative ? 1 : 0;
+  if (begin == text.size() || (text[begin] == '0' && text.size() > begin + 1))
+    return false;
+  if (isNegative && text[begin] == '0')
+    return false;
+
+  // accumulated negatively, since the most negative value has no positive
+  const std::int64_t min = (std::numeric_limits<std::int64_t>::min)();
+  std::int64_t result = 0;
+  for (std::size_t i = begin; i < text.size(); i++) {
+    if (!IsDigit(text[i]))
+      return false;
+    const int digit = text[i] - '0';
+    if (result < (min + digit) / 10)
+      return false;
+    result = result * 10 - digit;
+  }
+  if (!isNegative && result == min)
+    return false;
+
+  value = isNegative ? result : -result;
+  return true;
+}
+
+// ParseReal
+// . Only [-+]?(\.[0-9]+|[0-9]+(\.[0-9]*)?)([eE][-+]?[0-9]+)?, in range, so
+//   that the value is exactly what converting the text to a double gives.
+bool ParseReal(const std::string& text, double& value) {
+  std::size_t i = 0;
+  if (i < text.size() && (text[i] == '-' || text[i] == '+'))
+    i++;
+
+  std::size_t digits = 0;
+  for (; i < text.size() && IsDigit(text[i]); i++)
+    digits++;
+  if (i < text.size() && text[i] == '.') {
+    i++;
+    for (; i < text.size() && IsDigit(text[i]); i++)
+      digits++;
+  }
+  if (digits == 0)
+    return false;
+
+  if (i < text.size() && (text[i] == 'e' || text[i] == 'E')) {
+    i++;
+    if (i < text.size() && (text[i] == '-' || text[i] == '+'))
+      i++;
+    const std::size_t exponent = i;
+    for (; i < text.size() && IsDigit(text[i]); i++) {
+    }
+    if (i == exponent)
+      return false;
+  }
+  if (i != text.size())
+    return false;
+
+  // strtod stops early at the '.' in a locale that writes it otherwise
+  char* end = nullptr;
+  errno = 0;
+  const double result = std::strtod(text.c_str(), &end);
+  if (end != text.c_str() + text.size() || errno == ERANGE)
+    return false;
+
+  value = result;
+  return true;
+}
+}  // namespace
+
+packed_numbers::packed_numbers()
+    : m_isIntegral(true),
+      m_integers{},
+      m_reals{},
+      m_text{},
+      m_textEnds{} {}
+
+bool packed_numbers::append(const std::string& text) {
+  std::int64_t integer = 0;
+  if (m_isIntegral && ParseInteger(text, integer)) {
+    m_integers.push_back(integer);
+    return true;
+  }
+
+  double real = 0;
+  if (!ParseReal(text, real))
+    return false;
+
+  // the text is indexed by 32-bit offsets
+  const std::size_t maxText = (std::numeric_limits<std::uint32_t>::max)();
+  const std::size_t integerText =
+      m_isIntegral ? m_integers.size() *
+                         std::numeric_limits<std::int64_t>::digits10 + 2
+                   : 0;
+  if (m_text.size() + integerText + text.size() > maxText)
+    return false;
+
+  if (m_isIntegral)
+    convert_to_reals();
+  m_reals.push_back(real);
+  m_text += text;
+  m_textEnds.push_back(static_cast<std::uint32_t>(m_text.size()));
+  return true;
+}
+
+std::string packed_numbers::text(std::size_t index) const {
+  if (m_isIntegral)
+    return std::to_string(m_integers[index]);
+
+  const std::size_t begin = index > 0 ? m_textEnds[index - 1] : 0;
+  return m_text.substr(begin, m_textEnds[index] - begin);
+}
+
+// convert_to_reals
+// . The integers so far are exact as doubles only up to 2^53, but that's
+//   what converting their text to double would give, too.
+void packed_numbers::convert_to_reals() {
+  m_reals.reserve(m_integers.size() + 1);
+  m_textEnds.reserve(m_integers.size() + 1);
+  for (std::int64_t integer : m_integers) {
+    m_reals.push_back(static_cast<double>(integer));
+    m_text += std::to_string(integer);
+    m_textEnds.push_back(static_cast<std::uint32_t>(m_text.size()));
+  }
+
+  m_isIntegral = false;
+  std::vector<std::int64_t>().swap(m_integers);
+}
+}  // namespace detail
+}  // namespace YAML
@@ -1,28 +1,114 @@
 #include "yaml-cpp/node/parse.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <exception>
 #include <fstream>
 #include <sstream>
+#include <thread>
 
+#include "documentsplit.h"
 #include "nodebuilder.h"
+#include "nodeselector.h"
+#include "spanbuffer.h"
+#include "yaml-cpp/eventcursor.h"
+#include "yaml-cpp/depthguard.h"
+#include "yaml-cpp/exceptions.h"
+#include "yaml-cpp/node/documentstream.h"
 #include "yaml-cpp/node/impl.h"
 #include "yaml-cpp/node/node.h"
 #include "yaml-cpp/parser.h"
 
 namespace YAML {
+namespace {
+void LoadSpan(const char* input, const DocumentSpan& span,
+              std::vector<Node>& docs) {
+  const char* directives = input + span.directivesBegin;
+  const std::size_t directivesSize = span.directivesEnd - span.directivesBegin;
+  SpanBuffer buffer(directives, directivesSize, input + span.begin,
+                    span.end - span.begin);
+  std::istream stream(&buffer);
+
+  // the marks of the span's nodes are relative to the directives before it
+  const int directiveLines = static_cast<int>(
+      std::count(directives, directives + directivesSize, '\n'));
+  Mark origin;
+  origin.pos = static_cast<int>(span.begin - directivesSize);
+  origin.line = span.line - directiveLines;
+
+  Parser parser(stream);
+  try {
+    while (true) {
+      NodeBuilder builder(origin);
+      if (!builder.BuildNextDocument(parser)) {
+        break;
+      }
+      docs.push_back(builder.Root());
+    }
+  } catch (const DeepRecursion& e) {
+    throw DeepRecursion(e.depth(), FromOrigin(e.mark, origin), e.msg);
+  } catch (const ParserException& e) {
+    throw ParserException(FromOrigin(e.mark, origin), e.msg);
+  }
+}
+
+// LoadInMemory
+// . Loads the first document of the input, which the parser reads through
+//   a structural index if it's plain JSON.
+Node LoadInMemory(const char* input, std::size_t size, bool isPacked) {
+  Parser parser;
+  parser.Load(input, size);
+  NodeBuilder builder;
+  if (isPacked) {
+    builder.EnablePacking();
+  }
+  if (!builder.BuildNextDocument(parser)) {
+    return Node();
+  }
+
+  return builder.Root();
+}
+}  // namespace
+
 Node Load(const std::string& input) {
-  std::stringstream stream(input);
-  return Load(stream);
+  return LoadInMemory(input.data(), input.size(), false);
 }
 
 Node Load(const char* input) {
-  std::stringstream stream(input);
-  return Load(stream);
+  return LoadInMemory(input, std::strlen(input), false);
 }
 
 Node Load(std::istream& input) {
   Parser parser(input);
   NodeBuilder builder;
-  if (!parser.HandleNextDocument(builder)) {
+  if (!builder.BuildNextDocument(parser)) {
+    return Node();
+  }
+
+  return builder.Root();
+}
+
+Node LoadPipelined(std::istream& input) {
+  Parser parser(input);
+  parser.EnablePipelining();
+  NodeBuilder builder;
+  if (!builder.BuildNextDocument(parser)) {
+    return Node();
+  }
+
+  return builder.Root();
+}
+
+Node LoadPacked(const std::string& input) {
+  return LoadInMemory(input.data(), input.size(), true);
+}
+
+Node LoadPacked(std::istream& input) {
+  Parser parser(input);
+  NodeBuilder builder;
+  builder.EnablePacking();
+  if (!builder.BuildNextDocument(parser)) {
     return Node();
   }
 
@@ -37,6 +123,24 @@ Node LoadFile(const std::string& filename) {
   return Load(fin);
 }
 
+Node LoadSelected(const std::string& input,
+                  const std::vector<std::string>& paths) {
+  std::stringstream stream(input);
+  return LoadSelected(stream, paths);
+}
+
+Node LoadSelected(std::istream& input, const std::vector<std::string>& paths) {
+  Parser parser(input);
+  EventCursor cursor(parser);
+  NodeBuilder builder;
+  NodeSelector selector(cursor, builder, paths);
+  if (!selector.SelectDocument()) {
+    return Node();
+  }
+
+  return builder.Root();
+}
+
 std::vector<Node> LoadAll(const std::string& input) {
   std::stringstream stream(input);
   return LoadAll(stream);
@@ -49,16 +153,80 @@ std::vector<Node> LoadAll(const char* input) {
 
 std::vector<Node> LoadAll(std::istream& input) {
   std::vector<Node> docs;
+  DocumentStream stream(input);
+  while (stream.Next()) {
+    docs.push_back(stream.current());
+  }
+  return docs;
+}
 
-  Parser parser(input);
-  while (true) {
-    NodeBuilder builder;
-    if (!parser.HandleNextDocument(builder)) {
-      break;
+std::vector<Node> LoadAllParallel(const std::string& input,
+                                  std::size_t threads) {
+  return LoadAllParallel(input.data(), input.size(), threads);
+}
+
+std::vector<Node> LoadAllParallel(const char* input, std::size_t size,
+                                  std::size_t threads) {
+  if (threads == 0) {
+    threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+
+  // the stream skips a byte order mark without counting it in its marks
+  if (size >= 3 && std::equal(input, input + 3, "\xEF\xBB\xBF")) {
+    input += 3;
+    size -= 3;
+  }
+
+  // a few spans per thread balances the load, but there's no point cutting
+  // small input up at all
+  const std::size_t minSize =
+      std::max<std::size_t>(size / (threads * 4), 1 << 16);
+  std::vector<DocumentSpan> spans;
+  if (threads == 1 || !IsUtf8(input, size) ||
+      !SplitDocuments(input, size, minSize, spans) || spans.size() == 1) {
+    SpanBuffer buffer(input, 0, input, size);
+    std::istream stream(&buffer);
+    return LoadAll(stream);
+  }
+
+  std::vector<std::vector<Node>> results(spans.size());
+  std::vector<std::exception_ptr> errors(spans.size());
+  std::atomic<std::size_t> next(0);
+  std::atomic<std::size_t> firstError(spans.size());
+  auto work = [&]() {
+    for (std::size_t i = next++; i < spans.size(); i = next++) {
+      // nothing after a malformed document is needed
+      if (i > firstError) {
+        break;
+      }
+      try {
+        LoadSpan(input, spans[i], results[i]);
+      } catch (...) {
+        errors[i] = std::current_exception();
+        std::size_t error = firstError;
+        while (i < error && !firstError.compare_exchange_weak(error, i)) {
+        }
+      }
     }
-    docs.push_back(builder.Root());
+  };
+
+  std::vector<std::thread> workers;
+  for (std::size_t i = 1; i < std::min(threads, spans.size()); i++) {
+    workers.emplace_back(work);
+  }
+  work();
+  for (std::thread& worker : workers) {
+    worker.join();
   }
 
+  if (firstError < spans.size()) {
+    std::rethrow_exception(errors[firstError]);
+  }
+
+  std::vector<Node> docs;
+  for (std::vector<Node>& result : results) {
+    docs.insert(docs.end(), result.begin(), result.end());
+  }
   return docs;
 }
 
@@ -69,4 +237,38 @@ std::vector<Node> LoadAllFromFile(const std::string& filename) {
   }
   return LoadAll(fin);
 }
+
+DocumentStream::DocumentStream(std::istream& input)
+    : m_pParser(new Parser(input)),
+      m_document{},
+      m_isStarted(false),
+      m_isDone(false) {}
+
+DocumentStream::~DocumentStream() = default;
+
+bool DocumentStream::Next() {
+  m_isStarted = true;
+
+  // reset rather than assign, which would write through to the old document
+  m_document.reset();
+  if (m_isDone) {
+    return false;
+  }
+
+  NodeBuilder builder;
+  if (!builder.BuildNextDocument(*m_pParser)) {
+    m_isDone = true;
+    return false;
+  }
+
+  m_document.reset(builder.Root());
+  return true;
+}
+
+DocumentStream::iterator DocumentStream::begin() {
+  if (!m_isStarted && !Next()) {
+    return end();
+  }
+  return m_isDone ? end() : iterator(this);
+}
 }  // namespace YAML
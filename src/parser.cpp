@@ -2,16 +2,44 @@
 #include <sstream>
 
 #include "directives.h"  // IWYU pragma: keep
+#include "indexeddocparser.h"
+#include "nodebuilder.h"
 #include "scanner.h"     // IWYU pragma: keep
 #include "singledocparser.h"
+#include "spanbuffer.h"
+#include "structuralindex.h"
 #include "token.h"
 #include "yaml-cpp/exceptions.h"  // IWYU pragma: keep
 #include "yaml-cpp/parser.h"
 
 namespace YAML {
-class EventHandler;
-
-Parser::Parser() : m_pScanner{}, m_pDirectives{} {}
+const std::size_t Parser::DefaultMaxDepth;
+const std::size_t Parser::DefaultMaxAnchors;
+
+// MemoryInput
+// . The input given to Load in memory, and a stream over it for the scanner,
+//   in case it isn't read through its index.
+struct Parser::MemoryInput {
+  MemoryInput(const char* input_, std::size_t size_)
+      : input(input_), size(size_), buffer(nullptr, 0, input_, size_),
+        stream(&buffer) {}
+  MemoryInput(const MemoryInput&) = delete;
+  MemoryInput& operator=(const MemoryInput&) = delete;
+
+  const char* input;
+  std::size_t size;
+  SpanBuffer buffer;
+  std::istream stream;
+};
+
+Parser::Parser()
+    : m_pScanner{},
+      m_pDirectives{},
+      m_maxDepth(DefaultMaxDepth),
+      m_maxAnchors(DefaultMaxAnchors),
+      m_isPipelined(false),
+      m_pMemoryInput{},
+      m_isIndexable(false) {}
 
 Parser::Parser(std::istream& in) : Parser() { Load(in); }
 
@@ -22,22 +50,82 @@ Parser::operator bool() const { return m_pScanner && !m_pScanner->empty(); }
 void Parser::Load(std::istream& in) {
   m_pScanner.reset(new Scanner(in));
   m_pDirectives.reset(new Directives);
+  m_pMemoryInput.reset();
+  m_isIndexable = false;
+  if (m_isPipelined) {
+    m_pScanner->StartPipeline();
+  }
+}
+
+// a pipelined parser is already scanning, so its input isn't indexed
+void Parser::Load(const char* input, std::size_t size) {
+  std::unique_ptr<MemoryInput> pMemoryInput(new MemoryInput(input, size));
+  Load(pMemoryInput->stream);
+  m_pMemoryInput = std::move(pMemoryInput);
+  m_isIndexable = !m_isPipelined;
 }
 
 bool Parser::HandleNextDocument(EventHandler& eventHandler) {
+  return ParseNextDocument(eventHandler);
+}
+
+template <typename Handler>
+bool Parser::ParseNextDocument(Handler& handler) {
   if (!m_pScanner)
     return false;
 
+  // a document read through the index is the whole input
+  if (ParseIndexedDocument(handler)) {
+    m_pScanner.reset();
+    return true;
+  }
+
   ParseDirectives();
   if (m_pScanner->empty()) {
     return false;
   }
 
-  SingleDocParser sdp(*m_pScanner, *m_pDirectives);
-  sdp.HandleDocument(eventHandler);
+  SingleDocParser sdp(*m_pScanner, *m_pDirectives, m_maxDepth, m_maxAnchors);
+  sdp.HandleDocument(handler);
   return true;
 }
 
+template bool Parser::ParseNextDocument(NodeBuilder& handler);
+
+template <typename Handler>
+bool Parser::ParseIndexedDocument(Handler& handler) {
+  if (!m_isIndexable)
+    return false;
+  m_isIndexable = false;
+
+  const char* input = m_pMemoryInput->input;
+  const std::size_t size = m_pMemoryInput->size;
+  if (!IndexedDocParser::MayBeJson(input, size))
+    return false;
+
+  const StructuralIndex index(input, size);
+  const IndexedDocParser idp(input, size, index, m_maxDepth);
+  if (!idp.IsPlainJson())
+    return false;
+
+  idp.HandleDocument(handler);
+  return true;
+}
+
+void Parser::SetMaxDepth(std::size_t maxDepth) { m_maxDepth = maxDepth; }
+
+void Parser::SetMaxAnchors(std::size_t maxAnchors) {
+  m_maxAnchors = maxAnchors;
+}
+
+void Parser::EnablePipelining() {
+  m_isPipelined = true;
+  m_isIndexable = false;
+  if (m_pScanner) {
+    m_pScanner->StartPipeline();
+  }
+}
+
 void Parser::ParseDirectives() {
   bool readDirective = false;
 
@@ -111,6 +199,8 @@ void Parser::PrintTokens(std::ostream& out) {
     return;
   }
 
+  m_isIndexable = false;
+
   while (!m_pScanner->empty()) {
     out << m_pScanner->peek() << "\n";
     m_pScanner->pop();
@@ -1,22 +1,51 @@
 #include "regex_yaml.h"
 
+#include "stream.h"
+
 namespace YAML {
 // constructors
 
-RegEx::RegEx(REGEX_OP op) : m_op(op), m_a(0), m_z(0), m_params{} {}
+RegEx::RegEx(REGEX_OP op)
+    : m_op(op), m_a(0), m_z(0), m_params{}, m_first{}, m_canBeEmpty(false) {
+  IndexFirstChars();
+}
 RegEx::RegEx() : RegEx(REGEX_EMPTY) {}
 
-RegEx::RegEx(char ch) : m_op(REGEX_MATCH), m_a(ch), m_z(0), m_params{} {}
+RegEx::RegEx(char ch)
+    : m_op(REGEX_MATCH),
+      m_a(ch),
+      m_z(0),
+      m_params{},
+      m_first{},
+      m_canBeEmpty(false) {
+  IndexFirstChars();
+}
 
-RegEx::RegEx(char a, char z) : m_op(REGEX_RANGE), m_a(a), m_z(z), m_params{} {}
+RegEx::RegEx(char a, char z)
+    : m_op(REGEX_RANGE),
+      m_a(a),
+      m_z(z),
+      m_params{},
+      m_first{},
+      m_canBeEmpty(false) {
+  IndexFirstChars();
+}
 
 RegEx::RegEx(const std::string& str, REGEX_OP op)
-    : m_op(op), m_a(0), m_z(0), m_params(str.begin(), str.end()) {}
+    : m_op(op),
+      m_a(0),
+      m_z(0),
+      m_params(str.begin(), str.end()),
+      m_first{},
+      m_canBeEmpty(false) {
+  IndexFirstChars();
+}
 
 // combination constructors
 RegEx operator!(const RegEx& ex) {
   RegEx ret(REGEX_NOT);
   ret.m_params.push_back(ex);
+  ret.IndexFirstChars();
   return ret;
 }
 
@@ -24,6 +53,7 @@ RegEx operator|(const RegEx& ex1, const RegEx& ex2) {
   RegEx ret(REGEX_OR);
   ret.m_params.push_back(ex1);
   ret.m_params.push_back(ex2);
+  ret.IndexFirstChars();
   return ret;
 }
 
@@ -31,6 +61,7 @@ RegEx operator&(const RegEx& ex1, const RegEx& ex2) {
   RegEx ret(REGEX_AND);
   ret.m_params.push_back(ex1);
   ret.m_params.push_back(ex2);
+  ret.IndexFirstChars();
   return ret;
 }
 
@@ -38,6 +69,62 @@ RegEx operator+(const RegEx& ex1, const RegEx& ex2) {
   RegEx ret(REGEX_SEQ);
   ret.m_params.push_back(ex1);
   ret.m_params.push_back(ex2);
+  ret.IndexFirstChars();
   return ret;
 }
+
+// IndexFirstChars
+// . Works out, from the parameters, which characters a match can start with
+//   (erring on the side of too many), for CanStartWith.
+void RegEx::IndexFirstChars() {
+  m_first.reset();
+  m_canBeEmpty = false;
+  switch (m_op) {
+    case REGEX_EMPTY:
+      // only matches at the end of a stream
+      m_first.set(static_cast<unsigned char>(Stream::eof()));
+      m_canBeEmpty = true;
+      break;
+    case REGEX_MATCH:
+      m_first.set(static_cast<unsigned char>(m_a));
+      break;
+    case REGEX_RANGE:
+      for (int i = 0; i < 256; i++) {
+        const char ch = static_cast<char>(i);
+        if (m_a <= ch && ch <= m_z)
+          m_first.set(static_cast<std::size_t>(i));
+      }
+      break;
+    case REGEX_OR:
+      for (const RegEx& param : m_params) {
+        m_first |= param.m_first;
+        m_canBeEmpty = m_canBeEmpty || param.m_canBeEmpty;
+      }
+      break;
+    case REGEX_AND:
+      m_first.set();
+      for (const RegEx& param : m_params)
+        m_first &= param.m_first;
+      m_canBeEmpty = !m_params.empty() && m_params[0].m_canBeEmpty;
+      break;
+    case REGEX_NOT:
+      // matches one character, whatever its parameter doesn't
+      m_first.set();
+      break;
+    case REGEX_SEQ:
+      // a match starts with the first parameter that can't be empty, or
+      // with any before it that are
+      m_canBeEmpty = true;
+      for (const RegEx& param : m_params) {
+        m_first |= param.m_first;
+        if (!param.m_canBeEmpty) {
+          m_canBeEmpty = false;
+          break;
+        }
+      }
+      if (m_params.empty())
+        m_first.set();
+      break;
+  }
+}
 }  // namespace YAML
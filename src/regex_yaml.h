@@ -7,6 +7,7 @@
 #pragma once
 #endif
 
+#include <bitset>
 #include <string>
 #include <vector>
 
@@ -52,9 +53,18 @@ class YAML_CPP_API RegEx {
   template <typename Source>
   int Match(const Source& source) const;
 
+  // CanStartWith
+  // . Returns false if this can't match a stream whose next character is ch,
+  //   so the caller can skip calling Match on it; true doesn't mean it will.
+  bool CanStartWith(char ch) const {
+    return m_first[static_cast<unsigned char>(ch)];
+  }
+
  private:
   explicit RegEx(REGEX_OP op);
 
+  void IndexFirstChars();
+
   template <typename Source>
   bool IsValidSource(const Source& source) const;
   template <typename Source>
@@ -80,6 +90,10 @@ class YAML_CPP_API RegEx {
   char m_a{};
   char m_z{};
   std::vector<RegEx> m_params;
+
+  // the characters a match can start with, and whether it can be empty
+  std::bitset<256> m_first;
+  bool m_canBeEmpty;
 };
 }  // namespace YAML
 
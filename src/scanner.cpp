@@ -4,6 +4,7 @@
 #include "exp.h"
 #include "scanner.h"
 #include "token.h"
+#include "tokenring.h"
 #include "yaml-cpp/exceptions.h"  // IWYU pragma: keep
 
 namespace YAML {
@@ -17,22 +18,50 @@ Scanner::Scanner(std::istream& in)
       m_simpleKeys{},
       m_indents{},
       m_indentRefs{},
-      m_flows{} {}
-
-Scanner::~Scanner() = default;
+      m_retiredIndents{},
+      m_freeIndents{},
+      m_flows{},
+      m_pRing{},
+      m_producer{},
+      m_stopProducer(false),
+      m_producerDone(false),
+      m_producerError{} {}
+
+Scanner::~Scanner() {
+  if (m_producer.joinable()) {
+    m_stopProducer.store(true, std::memory_order_relaxed);
+    m_producer.join();
+  }
+}
 
 bool Scanner::empty() {
+  if (m_pRing) {
+    return !WaitForToken();
+  }
+
   EnsureTokensInQueue();
   return m_tokens.empty();
 }
 
 void Scanner::pop() {
+  if (m_pRing) {
+    if (WaitForToken())
+      m_pRing->pop();
+    return;
+  }
+
   EnsureTokensInQueue();
   if (!m_tokens.empty())
     m_tokens.pop();
 }
 
 Token& Scanner::peek() {
+  if (m_pRing) {
+    WaitForToken();
+    assert(!m_pRing->empty());
+    return m_pRing->front();
+  }
+
   EnsureTokensInQueue();
   assert(!m_tokens.empty());  // should we be asserting here? I mean, we really
                               // just be checking
@@ -50,6 +79,65 @@ Token& Scanner::peek() {
 
 Mark Scanner::mark() const { return INPUT.mark(); }
 
+void Scanner::StartPipeline() {
+  if (m_pRing) {
+    return;
+  }
+
+  // enough to let the scanner run well ahead, without holding much more of
+  // the input than it would anyway
+  const std::size_t capacity = 1024;
+  m_pRing.reset(new TokenRing(capacity));
+  m_producer = std::thread(&Scanner::RunPipeline, this);
+}
+
+// RunPipeline
+// . Moves each token into the ring as soon as it's valid, which is just
+//   what peek() would return if there were no pipeline. The tokens are still
+//   scanned through m_tokens, since the simple key and indent bookkeeping
+//   point into it.
+void Scanner::RunPipeline() {
+  try {
+    while (!m_stopProducer.load(std::memory_order_relaxed)) {
+      EnsureTokensInQueue();
+      if (m_tokens.empty()) {
+        break;
+      }
+
+      while (m_pRing->full()) {
+        if (m_stopProducer.load(std::memory_order_relaxed)) {
+          return;
+        }
+        std::this_thread::yield();
+      }
+      m_pRing->push(m_tokens.front());
+      m_tokens.pop();
+    }
+  } catch (...) {
+    m_producerError = std::current_exception();
+  }
+
+  // publishes everything above, including the end of the input's mark
+  m_producerDone.store(true, std::memory_order_release);
+}
+
+bool Scanner::WaitForToken() {
+  while (m_pRing->empty()) {
+    if (m_producerDone.load(std::memory_order_acquire)) {
+      // it may have pushed its last token just before finishing
+      if (!m_pRing->empty()) {
+        return true;
+      }
+      if (m_producerError) {
+        std::rethrow_exception(m_producerError);
+      }
+      return false;
+    }
+    std::this_thread::yield();
+  }
+  return true;
+}
+
 void Scanner::EnsureTokensInQueue() {
   while (true) {
     if (!m_tokens.empty()) {
@@ -103,6 +191,12 @@ void Scanner::ScanNextToken() {
     return EndStream();
   }
 
+  // most tokens in a flow collection (all of them, in JSON) don't need the
+  // general checks below
+  if (InFlowContext() && ScanJsonToken()) {
+    return;
+  }
+
   if (INPUT.column() == 0 && INPUT.peek() == Keys::Directive) {
     return ScanDirective();
   }
@@ -245,10 +339,7 @@ const RegEx& Scanner::GetValueRegex() const {
 void Scanner::StartStream() {
   m_startedStream = true;
   m_simpleKeyAllowed = true;
-  std::unique_ptr<IndentMarker> pIndent(
-      new IndentMarker(-1, IndentMarker::NONE));
-  m_indentRefs.push_back(std::move(pIndent));
-  m_indents.push(&m_indentRefs.back());
+  m_indents.push(NewIndentMarker(-1, IndentMarker::NONE));
 }
 
 void Scanner::EndStream() {
@@ -265,8 +356,7 @@ void Scanner::EndStream() {
 }
 
 Token* Scanner::PushToken(Token::TYPE type) {
-  m_tokens.push(Token(type, INPUT.mark()));
-  return &m_tokens.back();
+  return &m_tokens.push(type, INPUT.mark());
 }
 
 Token::TYPE Scanner::GetStartTokenFor(IndentMarker::INDENT_TYPE type) const {
@@ -290,27 +380,53 @@ Scanner::IndentMarker* Scanner::PushIndentTo(int column,
     return nullptr;
   }
 
-  std::unique_ptr<IndentMarker> pIndent(new IndentMarker(column, type));
-  IndentMarker& indent = *pIndent;
   const IndentMarker& lastIndent = *m_indents.top();
 
   // is this actually an indentation?
-  if (indent.column < lastIndent.column) {
+  if (column < lastIndent.column) {
     return nullptr;
   }
-  if (indent.column == lastIndent.column &&
-      !(indent.type == IndentMarker::SEQ &&
-        lastIndent.type == IndentMarker::MAP)) {
+  if (column == lastIndent.column &&
+      !(type == IndentMarker::SEQ && lastIndent.type == IndentMarker::MAP)) {
     return nullptr;
   }
 
   // push a start token
-  indent.pStartToken = PushToken(GetStartTokenFor(type));
+  IndentMarker* pIndent = NewIndentMarker(column, type);
+  pIndent->pStartToken = PushToken(GetStartTokenFor(type));
 
   // and then the indent
-  m_indents.push(&indent);
-  m_indentRefs.push_back(std::move(pIndent));
-  return &m_indentRefs.back();
+  m_indents.push(pIndent);
+  return pIndent;
+}
+
+// NewIndentMarker
+// . Reuses a marker that's been freed, if there is one.
+Scanner::IndentMarker* Scanner::NewIndentMarker(
+    int column, IndentMarker::INDENT_TYPE type) {
+  if (m_freeIndents.empty()) {
+    m_indentRefs.push_back(
+        std::unique_ptr<IndentMarker>(new IndentMarker(column, type)));
+    return &m_indentRefs.back();
+  }
+
+  IndentMarker* pIndent = m_freeIndents.back();
+  m_freeIndents.pop_back();
+  *pIndent = IndentMarker(column, type);
+  return pIndent;
+}
+
+// FreeRetiredIndents
+// . Popped markers may still be pointed to by a simple key, so they can only
+//   be reused once there aren't any.
+void Scanner::FreeRetiredIndents() {
+  if (!m_simpleKeys.empty()) {
+    return;
+  }
+
+  m_freeIndents.insert(m_freeIndents.end(), m_retiredIndents.begin(),
+                       m_retiredIndents.end());
+  m_retiredIndents.clear();
 }
 
 void Scanner::PopIndentToHere() {
@@ -358,19 +474,20 @@ void Scanner::PopAllIndents() {
 }
 
 void Scanner::PopIndent() {
-  const IndentMarker& indent = *m_indents.top();
+  IndentMarker* pIndent = m_indents.top();
+  const IndentMarker& indent = *pIndent;
   m_indents.pop();
+  m_retiredIndents.push_back(pIndent);
 
   if (indent.status != IndentMarker::VALID) {
     InvalidateSimpleKey();
-    return;
-  }
-
-  if (indent.type == IndentMarker::SEQ) {
-    m_tokens.push(Token(Token::BLOCK_SEQ_END, INPUT.mark()));
+  } else if (indent.type == IndentMarker::SEQ) {
+    m_tokens.push(Token::BLOCK_SEQ_END, INPUT.mark());
   } else if (indent.type == IndentMarker::MAP) {
-    m_tokens.push(Token(Token::BLOCK_MAP_END, INPUT.mark()));
+    m_tokens.push(Token::BLOCK_MAP_END, INPUT.mark());
   }
+
+  FreeRetiredIndents();
 }
 
 int Scanner::GetTopIndent() const {
@@ -7,20 +7,26 @@
 #pragma once
 #endif
 
+#include <atomic>
 #include <cstddef>
+#include <exception>
 #include <ios>
-#include <queue>
+#include <memory>
 #include <stack>
 #include <string>
+#include <thread>
+#include <vector>
 
 #include "ptr_vector.h"
 #include "stream.h"
 #include "token.h"
+#include "tokenqueue.h"
 #include "yaml-cpp/mark.h"
 
 namespace YAML {
 class Node;
 class RegEx;
+class TokenRing;
 
 /**
  * A scanner transforms a stream of characters into a stream of tokens.
@@ -42,6 +48,23 @@ class Scanner {
   /** Returns the current mark in the input stream. */
   Mark mark() const;
 
+  /**
+   * Starts scanning the rest of the input on a second thread, which runs
+   * ahead into a ring of tokens that {@link #empty}, {@link #peek} and {@link
+   * #pop} then read from. Errors are rethrown by those once the tokens before
+   * them have been read. The input stream mustn't be used elsewhere until the
+   * scanner is destroyed, and {@link #mark} may only be called once it's
+   * empty.
+   */
+  void StartPipeline();
+
+  // indent markers, for tests: every one allocated is in use, retired
+  // (popped, but maybe still pointed to by a simple key) or free to reuse
+  std::size_t IndentMarkersAllocated() const { return m_indentRefs.size(); }
+  std::size_t IndentMarkersInUse() const { return m_indents.size(); }
+  std::size_t IndentMarkersRetired() const { return m_retiredIndents.size(); }
+  std::size_t IndentMarkersFree() const { return m_freeIndents.size(); }
+
  private:
   struct IndentMarker {
     enum INDENT_TYPE { MAP, SEQ, NONE };
@@ -76,6 +99,16 @@ class Scanner {
   /** Eats the input stream until it reaches the next token-like thing. */
   void ScanToNextToken();
 
+  /** Scans into the token ring, on the pipeline's thread. */
+  void RunPipeline();
+
+  /**
+   * Waits until there's a token in the ring, or the pipeline has finished.
+   *
+   * @return false if it has finished and there are no more tokens.
+   */
+  bool WaitForToken();
+
   /** Sets the initial conditions for starting a stream. */
   void StartStream();
 
@@ -113,6 +146,15 @@ class Scanner {
 
   /** Pops a single indent, pushing the proper token. */
   void PopIndent();
+
+  /** Returns a new indent marker, reusing a freed one if it can. */
+  IndentMarker *NewIndentMarker(int column, IndentMarker::INDENT_TYPE type);
+
+  /**
+   * Frees the popped indent markers for reuse, if no simple key could still
+   * point to one.
+   */
+  void FreeRetiredIndents();
   int GetTopIndent() const;
 
   // checking input
@@ -148,6 +190,18 @@ class Scanner {
     Token *pMapStart, *pKey;
   };
 
+  /**
+   * Scans the next token if it's one that JSON has (a flow indicator, a
+   * string without escapes or line breaks, or a number or literal that a flow
+   * indicator ends), with the same result as the general checks but without
+   * running them.
+   *
+   * @return false, having read nothing, if the next token isn't one of these.
+   */
+  bool ScanJsonToken();
+  void ScanJsonString(std::size_t length);
+  void ScanJsonWord(std::size_t length);
+
   // and the tokens
   void ScanDirective();
   void ScanDocStart();
@@ -172,7 +226,7 @@ class Scanner {
   Stream INPUT;
 
   // the output (tokens)
-  std::queue<Token> m_tokens;
+  TokenQueue m_tokens;
 
   // state info
   bool m_startedStream, m_endedStream;
@@ -181,7 +235,16 @@ class Scanner {
   std::stack<SimpleKey> m_simpleKeys;
   std::stack<IndentMarker *> m_indents;
   ptr_vector<IndentMarker> m_indentRefs;  // for "garbage collection"
+  std::vector<IndentMarker *> m_retiredIndents;  // popped, maybe still used
+  std::vector<IndentMarker *> m_freeIndents;     // popped and unused
   std::stack<FLOW_MARKER> m_flows;
+
+  // the pipeline, if it's been started
+  std::unique_ptr<TokenRing> m_pRing;
+  std::thread m_producer;
+  std::atomic<bool> m_stopProducer;
+  std::atomic<bool> m_producerDone;
+  std::exception_ptr m_producerError;
 };
 }
 
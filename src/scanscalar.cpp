@@ -18,14 +18,18 @@ namespace YAML {
 //
 // . Depending on the parameters given, we store or stop
 //   and different places in the above flow.
-std::string ScanScalar(Stream& INPUT, ScanScalarParams& params) {
+//
+// . The scalar is scanned into the given string, replacing what it held but
+//   reusing its storage.
+void ScanScalar(Stream& INPUT, ScanScalarParams& params,
+                std::string& scalar) {
   bool foundNonEmptyLine = false;
   bool pastOpeningBreak = (params.fold == FOLD_FLOW);
   bool emptyLine = false, moreIndented = false;
   int foldedNewlineCount = 0;
   bool foldedNewlineStartedMoreIndented = false;
   std::size_t lastEscapedChar = std::string::npos;
-  std::string scalar;
+  scalar.clear();
   params.leadingSpaces = false;
 
   if (!params.end) {
@@ -38,7 +42,26 @@ std::string ScanScalar(Stream& INPUT, ScanScalarParams& params) {
 
     std::size_t lastNonWhitespaceChar = scalar.size();
     bool escapedNewline = false;
-    while (!params.end->Matches(INPUT) && !Exp::Break().Matches(INPUT)) {
+    while (true) {
+      // most characters can't start the end, a line break, an escape or (past
+      // the first column) a document indicator, so they skip all the checks
+      // below
+      const char next = INPUT.peek();
+      if (INPUT.column() != 0 && next != Stream::eof() &&
+          next != params.escape && !params.end->CanStartWith(next) &&
+          !Exp::Break().CanStartWith(next)) {
+        foundNonEmptyLine = true;
+        pastOpeningBreak = true;
+        scalar += INPUT.get();
+        if (next != ' ' && next != '\t') {
+          lastNonWhitespaceChar = scalar.size();
+        }
+        continue;
+      }
+
+      if (params.end->Matches(INPUT) || Exp::Break().Matches(INPUT)) {
+        break;
+      }
       if (!INPUT) {
         break;
       }
@@ -245,7 +268,5 @@ std::string ScanScalar(Stream& INPUT, ScanScalarParams& params) {
     default:
       break;
   }
-
-  return scalar;
 }
 }  // namespace YAML
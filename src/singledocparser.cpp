@@ -1,11 +1,12 @@
 #include <algorithm>
+#include <cassert>
 #include <cstdio>
 #include <sstream>
 
-#include "collectionstack.h"  // IWYU pragma: keep
+#include "eventqueue.h"
+#include "nodebuilder.h"
 #include "scanner.h"
 #include "singledocparser.h"
-#include "tag.h"
 #include "token.h"
 #include "yaml-cpp/depthguard.h"
 #include "yaml-cpp/emitterstyle.h"
@@ -15,21 +16,37 @@
 #include "yaml-cpp/null.h"
 
 namespace YAML {
-SingleDocParser::SingleDocParser(Scanner& scanner, const Directives& directives)
+SingleDocParser::SingleDocParser(Scanner& scanner, const Directives& directives,
+                                 std::size_t maxDepth, std::size_t maxAnchors)
     : m_scanner(scanner),
       m_directives(directives),
-      m_pCollectionStack(new CollectionStack),
+      m_maxDepth(maxDepth),
+      m_states{},
+      m_maxAnchors(maxAnchors),
       m_anchors{},
-      m_curAnchor(0) {}
+      m_tags(directives) {}
 
 SingleDocParser::~SingleDocParser() = default;
 
 // HandleDocument
 // . Handles the next document
 // . Throws a ParserException on error.
-void SingleDocParser::HandleDocument(EventHandler& eventHandler) {
+template <typename Handler>
+void SingleDocParser::HandleDocument(Handler& eventHandler) {
+  StartDocument(eventHandler);
+  while (Depth() > 0)
+    HandleNextState(eventHandler);
+  EndDocument(eventHandler);
+}
+
+// StartDocument
+// . Emits the document start, and then the root node, or the start of it if
+//   it is a collection.
+template <typename Handler>
+void SingleDocParser::StartDocument(Handler& eventHandler) {
   assert(!m_scanner.empty());  // guaranteed that there are tokens
-  assert(!m_curAnchor);
+  assert(!m_anchors.AnchorCount());
+  assert(m_states.empty());
 
   eventHandler.OnDocumentStart(m_scanner.peek().mark);
 
@@ -37,8 +54,12 @@ void SingleDocParser::HandleDocument(EventHandler& eventHandler) {
   if (m_scanner.peek().type == Token::DOC_START)
     m_scanner.pop();
 
-  // recurse!
-  HandleNode(eventHandler);
+  StartNode(eventHandler);
+}
+
+template <typename Handler>
+void SingleDocParser::EndDocument(Handler& eventHandler) {
+  assert(m_states.empty());
 
   eventHandler.OnDocumentEnd();
 
@@ -47,9 +68,56 @@ void SingleDocParser::HandleDocument(EventHandler& eventHandler) {
     m_scanner.pop();
 }
 
-void SingleDocParser::HandleNode(EventHandler& eventHandler) {
-  DepthGuard<500> depthguard(depth, m_scanner.mark(), ErrorMsg::BAD_FILE);
+// HandleNextState
+// . Advances the innermost open collection by one step: it either ends, or
+//   its next key, value or entry is started.
+// . Instead of recursing into collections, every open collection keeps a
+//   frame on m_states that says where to resume once its current child is
+//   done, so nesting depth is bounded only by m_maxDepth.
+template <typename Handler>
+void SingleDocParser::HandleNextState(Handler& eventHandler) {
+  assert(!m_states.empty());
+
+  switch (m_states.back().state) {
+    case State::BlockSeqEntry:
+      HandleBlockSequenceEntry(eventHandler);
+      break;
+    case State::FlowSeqEntry:
+      HandleFlowSequenceEntry(eventHandler);
+      break;
+    case State::FlowSeqSeparator:
+      HandleFlowSequenceSeparator();
+      break;
+    case State::BlockMapKey:
+      HandleBlockMapKey(eventHandler);
+      break;
+    case State::BlockMapValue:
+      HandleBlockMapValue(eventHandler);
+      break;
+    case State::FlowMapKey:
+      HandleFlowMapKey(eventHandler);
+      break;
+    case State::FlowMapValue:
+      HandleFlowMapValue(eventHandler);
+      break;
+    case State::FlowMapSeparator:
+      HandleFlowMapSeparator();
+      break;
+    case State::CompactMapValue:
+      HandleCompactMapValue(eventHandler);
+      break;
+    case State::CompactMapEnd:
+      m_states.pop_back();
+      eventHandler.OnMapEnd();
+      break;
+  }
+}
 
+// StartNode
+// . Emits a complete scalar, null or alias node, or opens a collection by
+//   emitting its start event and pushing its first state.
+template <typename Handler>
+void SingleDocParser::StartNode(Handler& eventHandler) {
   // an empty node *is* a possibility
   if (m_scanner.empty()) {
     eventHandler.OnNull(m_scanner.mark(), NullAnchor);
@@ -62,8 +130,7 @@ void SingleDocParser::HandleNode(EventHandler& eventHandler) {
   // special case: a value node by itself must be a map, with no header
   if (m_scanner.peek().type == Token::VALUE) {
     eventHandler.OnMapStart(mark, "?", NullAnchor, EmitterStyle::Default);
-    HandleMap(eventHandler);
-    eventHandler.OnMapEnd();
+    StartCompactMap(eventHandler);
     return;
   }
 
@@ -74,13 +141,13 @@ void SingleDocParser::HandleNode(EventHandler& eventHandler) {
     return;
   }
 
-  std::string tag;
-  std::string anchor_name;
+  const std::string* pTag;
+  const std::string* pAnchorName;
   anchor_t anchor;
-  ParseProperties(tag, anchor, anchor_name);
+  ParseProperties(pTag, anchor, pAnchorName);
 
-  if (!anchor_name.empty())
-    eventHandler.OnAnchor(mark, anchor_name);
+  if (pAnchorName)
+    eventHandler.OnAnchor(mark, *pAnchorName);
 
   // after parsing properties, an empty node is again a possibility
   if (m_scanner.empty()) {
@@ -91,9 +158,10 @@ void SingleDocParser::HandleNode(EventHandler& eventHandler) {
   const Token& token = m_scanner.peek();
 
   // add non-specific tags
-  if (tag.empty())
-    tag = (token.type == Token::NON_PLAIN_SCALAR ? "!" : "?");
-  
+  if (!pTag || pTag->empty())
+    pTag = &m_tags.NonSpecific(token.type == Token::NON_PLAIN_SCALAR);
+  const std::string& tag = *pTag;
+
   if (token.type == Token::PLAIN_SCALAR 
       && tag.compare("?") == 0 && IsNullString(token.value)) {
     eventHandler.OnNull(mark, anchor);
@@ -109,32 +177,30 @@ void SingleDocParser::HandleNode(EventHandler& eventHandler) {
       m_scanner.pop();
       return;
     case Token::FLOW_SEQ_START:
+      PushState(State::FlowSeqEntry, mark);
       eventHandler.OnSequenceStart(mark, tag, anchor, EmitterStyle::Flow);
-      HandleSequence(eventHandler);
-      eventHandler.OnSequenceEnd();
+      m_scanner.pop();
       return;
     case Token::BLOCK_SEQ_START:
+      PushState(State::BlockSeqEntry, mark);
       eventHandler.OnSequenceStart(mark, tag, anchor, EmitterStyle::Block);
-      HandleSequence(eventHandler);
-      eventHandler.OnSequenceEnd();
+      m_scanner.pop();
       return;
     case Token::FLOW_MAP_START:
+      PushState(State::FlowMapKey, mark);
       eventHandler.OnMapStart(mark, tag, anchor, EmitterStyle::Flow);
-      HandleMap(eventHandler);
-      eventHandler.OnMapEnd();
+      m_scanner.pop();
       return;
     case Token::BLOCK_MAP_START:
+      PushState(State::BlockMapKey, mark);
       eventHandler.OnMapStart(mark, tag, anchor, EmitterStyle::Block);
-      HandleMap(eventHandler);
-      eventHandler.OnMapEnd();
+      m_scanner.pop();
       return;
     case Token::KEY:
       // compact maps can only go in a flow sequence
-      if (m_pCollectionStack->GetCurCollectionType() ==
-          CollectionType::FlowSeq) {
+      if (InFlowSequence()) {
         eventHandler.OnMapStart(mark, tag, anchor, EmitterStyle::Flow);
-        HandleMap(eventHandler);
-        eventHandler.OnMapEnd();
+        StartCompactMap(eventHandler);
         return;
       }
       break;
@@ -148,233 +214,228 @@ void SingleDocParser::HandleNode(EventHandler& eventHandler) {
     eventHandler.OnScalar(mark, tag, anchor, "");
 }
 
-void SingleDocParser::HandleSequence(EventHandler& eventHandler) {
-  // split based on start token
-  switch (m_scanner.peek().type) {
-    case Token::BLOCK_SEQ_START:
-      HandleBlockSequence(eventHandler);
-      break;
-    case Token::FLOW_SEQ_START:
-      HandleFlowSequence(eventHandler);
-      break;
-    default:
-      break;
+void SingleDocParser::PushState(State::value state, const Mark& mark) {
+  if (m_states.size() >= m_maxDepth) {
+    throw DeepRecursion(static_cast<int>(m_states.size() + 1), mark,
+                        ErrorMsg::BAD_FILE);
   }
+  m_states.push_back({state, mark});
 }
 
-void SingleDocParser::HandleBlockSequence(EventHandler& eventHandler) {
-  // eat start token
-  m_scanner.pop();
-  m_pCollectionStack->PushCollectionType(CollectionType::BlockSeq);
+bool SingleDocParser::InFlowSequence() const {
+  if (m_states.empty())
+    return false;
 
-  while (true) {
-    if (m_scanner.empty())
-      throw ParserException(m_scanner.mark(), ErrorMsg::END_OF_SEQ);
+  const State::value state = m_states.back().state;
+  return state == State::FlowSeqEntry || state == State::FlowSeqSeparator;
+}
 
-    Token token = m_scanner.peek();
-    if (token.type != Token::BLOCK_ENTRY && token.type != Token::BLOCK_SEQ_END)
-      throw ParserException(token.mark, ErrorMsg::END_OF_SEQ);
+template <typename Handler>
+void SingleDocParser::HandleBlockSequenceEntry(Handler& eventHandler) {
+  if (m_scanner.empty())
+    throw ParserException(m_scanner.mark(), ErrorMsg::END_OF_SEQ);
 
-    m_scanner.pop();
-    if (token.type == Token::BLOCK_SEQ_END)
-      break;
+  const Token& token = m_scanner.peek();
+  if (token.type != Token::BLOCK_ENTRY && token.type != Token::BLOCK_SEQ_END)
+    throw ParserException(token.mark, ErrorMsg::END_OF_SEQ);
 
-    // check for null
-    if (!m_scanner.empty()) {
-      const Token& nextToken = m_scanner.peek();
-      if (nextToken.type == Token::BLOCK_ENTRY ||
-          nextToken.type == Token::BLOCK_SEQ_END) {
-        eventHandler.OnNull(nextToken.mark, NullAnchor);
-        continue;
-      }
-    }
+  const bool isEnd = token.type == Token::BLOCK_SEQ_END;
+  m_scanner.pop();
+  if (isEnd) {
+    m_states.pop_back();
+    eventHandler.OnSequenceEnd();
+    return;
+  }
 
-    HandleNode(eventHandler);
+  // check for null
+  if (!m_scanner.empty()) {
+    const Token& nextToken = m_scanner.peek();
+    if (nextToken.type == Token::BLOCK_ENTRY ||
+        nextToken.type == Token::BLOCK_SEQ_END) {
+      eventHandler.OnNull(nextToken.mark, NullAnchor);
+      return;
+    }
   }
 
-  m_pCollectionStack->PopCollectionType(CollectionType::BlockSeq);
+  StartNode(eventHandler);
 }
 
-void SingleDocParser::HandleFlowSequence(EventHandler& eventHandler) {
-  // eat start token
-  m_scanner.pop();
-  m_pCollectionStack->PushCollectionType(CollectionType::FlowSeq);
-
-  while (true) {
-    if (m_scanner.empty())
-      throw ParserException(m_scanner.mark(), ErrorMsg::END_OF_SEQ_FLOW);
+template <typename Handler>
+void SingleDocParser::HandleFlowSequenceEntry(Handler& eventHandler) {
+  if (m_scanner.empty())
+    throw ParserException(m_scanner.mark(), ErrorMsg::END_OF_SEQ_FLOW);
 
-    // first check for end
-    if (m_scanner.peek().type == Token::FLOW_SEQ_END) {
-      m_scanner.pop();
-      break;
-    }
+  // first check for end
+  if (m_scanner.peek().type == Token::FLOW_SEQ_END) {
+    m_scanner.pop();
+    m_states.pop_back();
+    eventHandler.OnSequenceEnd();
+    return;
+  }
 
-    // then read the node
-    HandleNode(eventHandler);
+  // then read the node
+  m_states.back().state = State::FlowSeqSeparator;
+  StartNode(eventHandler);
+}
 
-    if (m_scanner.empty())
-      throw ParserException(m_scanner.mark(), ErrorMsg::END_OF_SEQ_FLOW);
+void SingleDocParser::HandleFlowSequenceSeparator() {
+  if (m_scanner.empty())
+    throw ParserException(m_scanner.mark(), ErrorMsg::END_OF_SEQ_FLOW);
 
-    // now eat the separator (or could be a sequence end, which we ignore - but
-    // if it's neither, then it's a bad node)
-    Token& token = m_scanner.peek();
-    if (token.type == Token::FLOW_ENTRY)
-      m_scanner.pop();
-    else if (token.type != Token::FLOW_SEQ_END)
-      throw ParserException(token.mark, ErrorMsg::END_OF_SEQ_FLOW);
-  }
+  // now eat the separator (or could be a sequence end, which we ignore - but
+  // if it's neither, then it's a bad node)
+  Token& token = m_scanner.peek();
+  if (token.type == Token::FLOW_ENTRY)
+    m_scanner.pop();
+  else if (token.type != Token::FLOW_SEQ_END)
+    throw ParserException(token.mark, ErrorMsg::END_OF_SEQ_FLOW);
 
-  m_pCollectionStack->PopCollectionType(CollectionType::FlowSeq);
+  m_states.back().state = State::FlowSeqEntry;
 }
 
-void SingleDocParser::HandleMap(EventHandler& eventHandler) {
-  // split based on start token
-  switch (m_scanner.peek().type) {
-    case Token::BLOCK_MAP_START:
-      HandleBlockMap(eventHandler);
-      break;
-    case Token::FLOW_MAP_START:
-      HandleFlowMap(eventHandler);
-      break;
-    case Token::KEY:
-      HandleCompactMap(eventHandler);
-      break;
-    case Token::VALUE:
-      HandleCompactMapWithNoKey(eventHandler);
-      break;
-    default:
-      break;
+// StartCompactMap
+// . Single "key: value" or ": value" pair in a flow sequence
+template <typename Handler>
+void SingleDocParser::StartCompactMap(Handler& eventHandler) {
+  Mark mark = m_scanner.peek().mark;
+
+  if (m_scanner.peek().type == Token::KEY) {
+    // grab key
+    PushState(State::CompactMapValue, mark);
+    m_scanner.pop();
+    StartNode(eventHandler);
+    return;
   }
-}
 
-void SingleDocParser::HandleBlockMap(EventHandler& eventHandler) {
-  // eat start token
+  // null key, then grab value
+  assert(m_scanner.peek().type == Token::VALUE);
+  PushState(State::CompactMapEnd, mark);
+  eventHandler.OnNull(mark, NullAnchor);
   m_scanner.pop();
-  m_pCollectionStack->PushCollectionType(CollectionType::BlockMap);
+  StartNode(eventHandler);
+}
 
-  while (true) {
-    if (m_scanner.empty())
-      throw ParserException(m_scanner.mark(), ErrorMsg::END_OF_MAP);
+template <typename Handler>
+void SingleDocParser::HandleCompactMapValue(Handler& eventHandler) {
+  Frame& frame = m_states.back();
+  frame.state = State::CompactMapEnd;
 
-    Token token = m_scanner.peek();
-    if (token.type != Token::KEY && token.type != Token::VALUE &&
-        token.type != Token::BLOCK_MAP_END)
-      throw ParserException(token.mark, ErrorMsg::END_OF_MAP);
+  // now grab value (optional)
+  if (!m_scanner.empty() && m_scanner.peek().type == Token::VALUE) {
+    m_scanner.pop();
+    StartNode(eventHandler);
+  } else {
+    eventHandler.OnNull(frame.mark, NullAnchor);
+  }
+}
 
-    if (token.type == Token::BLOCK_MAP_END) {
-      m_scanner.pop();
-      break;
-    }
+template <typename Handler>
+void SingleDocParser::HandleBlockMapKey(Handler& eventHandler) {
+  if (m_scanner.empty())
+    throw ParserException(m_scanner.mark(), ErrorMsg::END_OF_MAP);
 
-    // grab key (if non-null)
-    if (token.type == Token::KEY) {
-      m_scanner.pop();
-      HandleNode(eventHandler);
-    } else {
-      eventHandler.OnNull(token.mark, NullAnchor);
-    }
+  const Token& token = m_scanner.peek();
+  if (token.type != Token::KEY && token.type != Token::VALUE &&
+      token.type != Token::BLOCK_MAP_END)
+    throw ParserException(token.mark, ErrorMsg::END_OF_MAP);
 
-    // now grab value (optional)
-    if (!m_scanner.empty() && m_scanner.peek().type == Token::VALUE) {
-      m_scanner.pop();
-      HandleNode(eventHandler);
-    } else {
-      eventHandler.OnNull(token.mark, NullAnchor);
-    }
+  if (token.type == Token::BLOCK_MAP_END) {
+    m_scanner.pop();
+    m_states.pop_back();
+    eventHandler.OnMapEnd();
+    return;
   }
 
-  m_pCollectionStack->PopCollectionType(CollectionType::BlockMap);
-}
+  Frame& frame = m_states.back();
+  frame.state = State::BlockMapValue;
+  frame.mark = token.mark;
 
-void SingleDocParser::HandleFlowMap(EventHandler& eventHandler) {
-  // eat start token
-  m_scanner.pop();
-  m_pCollectionStack->PushCollectionType(CollectionType::FlowMap);
+  // grab key (if non-null)
+  if (token.type == Token::KEY) {
+    m_scanner.pop();
+    StartNode(eventHandler);
+  } else {
+    eventHandler.OnNull(token.mark, NullAnchor);
+  }
+}
 
-  while (true) {
-    if (m_scanner.empty())
-      throw ParserException(m_scanner.mark(), ErrorMsg::END_OF_MAP_FLOW);
+template <typename Handler>
+void SingleDocParser::HandleBlockMapValue(Handler& eventHandler) {
+  Frame& frame = m_states.back();
+  frame.state = State::BlockMapKey;
 
-    Token& token = m_scanner.peek();
-    const Mark mark = token.mark;
-    // first check for end
-    if (token.type == Token::FLOW_MAP_END) {
-      m_scanner.pop();
-      break;
-    }
+  // now grab value (optional)
+  if (!m_scanner.empty() && m_scanner.peek().type == Token::VALUE) {
+    m_scanner.pop();
+    StartNode(eventHandler);
+  } else {
+    eventHandler.OnNull(frame.mark, NullAnchor);
+  }
+}
 
-    // grab key (if non-null)
-    if (token.type == Token::KEY) {
-      m_scanner.pop();
-      HandleNode(eventHandler);
-    } else {
-      eventHandler.OnNull(mark, NullAnchor);
-    }
+template <typename Handler>
+void SingleDocParser::HandleFlowMapKey(Handler& eventHandler) {
+  if (m_scanner.empty())
+    throw ParserException(m_scanner.mark(), ErrorMsg::END_OF_MAP_FLOW);
 
-    // now grab value (optional)
-    if (!m_scanner.empty() && m_scanner.peek().type == Token::VALUE) {
-      m_scanner.pop();
-      HandleNode(eventHandler);
-    } else {
-      eventHandler.OnNull(mark, NullAnchor);
-    }
+  const Token& token = m_scanner.peek();
+  // first check for end
+  if (token.type == Token::FLOW_MAP_END) {
+    m_scanner.pop();
+    m_states.pop_back();
+    eventHandler.OnMapEnd();
+    return;
+  }
 
-    if (m_scanner.empty())
-      throw ParserException(m_scanner.mark(), ErrorMsg::END_OF_MAP_FLOW);
+  Frame& frame = m_states.back();
+  frame.state = State::FlowMapValue;
+  frame.mark = token.mark;
 
-    // now eat the separator (or could be a map end, which we ignore - but if
-    // it's neither, then it's a bad node)
-    Token& nextToken = m_scanner.peek();
-    if (nextToken.type == Token::FLOW_ENTRY)
-      m_scanner.pop();
-    else if (nextToken.type != Token::FLOW_MAP_END)
-      throw ParserException(nextToken.mark, ErrorMsg::END_OF_MAP_FLOW);
+  // grab key (if non-null)
+  if (token.type == Token::KEY) {
+    m_scanner.pop();
+    StartNode(eventHandler);
+  } else {
+    eventHandler.OnNull(frame.mark, NullAnchor);
   }
-
-  m_pCollectionStack->PopCollectionType(CollectionType::FlowMap);
 }
 
-// . Single "key: value" pair in a flow sequence
-void SingleDocParser::HandleCompactMap(EventHandler& eventHandler) {
-  m_pCollectionStack->PushCollectionType(CollectionType::CompactMap);
-
-  // grab key
-  Mark mark = m_scanner.peek().mark;
-  m_scanner.pop();
-  HandleNode(eventHandler);
+template <typename Handler>
+void SingleDocParser::HandleFlowMapValue(Handler& eventHandler) {
+  Frame& frame = m_states.back();
+  frame.state = State::FlowMapSeparator;
 
   // now grab value (optional)
   if (!m_scanner.empty() && m_scanner.peek().type == Token::VALUE) {
     m_scanner.pop();
-    HandleNode(eventHandler);
+    StartNode(eventHandler);
   } else {
-    eventHandler.OnNull(mark, NullAnchor);
+    eventHandler.OnNull(frame.mark, NullAnchor);
   }
-
-  m_pCollectionStack->PopCollectionType(CollectionType::CompactMap);
 }
 
-// . Single ": value" pair in a flow sequence
-void SingleDocParser::HandleCompactMapWithNoKey(EventHandler& eventHandler) {
-  m_pCollectionStack->PushCollectionType(CollectionType::CompactMap);
-
-  // null key
-  eventHandler.OnNull(m_scanner.peek().mark, NullAnchor);
+void SingleDocParser::HandleFlowMapSeparator() {
+  if (m_scanner.empty())
+    throw ParserException(m_scanner.mark(), ErrorMsg::END_OF_MAP_FLOW);
 
-  // grab value
-  m_scanner.pop();
-  HandleNode(eventHandler);
+  // now eat the separator (or could be a map end, which we ignore - but if
+  // it's neither, then it's a bad node)
+  Token& nextToken = m_scanner.peek();
+  if (nextToken.type == Token::FLOW_ENTRY)
+    m_scanner.pop();
+  else if (nextToken.type != Token::FLOW_MAP_END)
+    throw ParserException(nextToken.mark, ErrorMsg::END_OF_MAP_FLOW);
 
-  m_pCollectionStack->PopCollectionType(CollectionType::CompactMap);
+  m_states.back().state = State::FlowMapKey;
 }
 
 // ParseProperties
 // . Grabs any tag or anchor tokens and deals with them.
-void SingleDocParser::ParseProperties(std::string& tag, anchor_t& anchor,
-                                      std::string& anchor_name) {
-  tag.clear();
-  anchor_name.clear();
+void SingleDocParser::ParseProperties(const std::string*& pTag,
+                                      anchor_t& anchor,
+                                      const std::string*& pAnchorName) {
+  pTag = nullptr;
+  pAnchorName = nullptr;
   anchor = NullAnchor;
 
   while (true) {
@@ -383,10 +444,10 @@ void SingleDocParser::ParseProperties(std::string& tag, anchor_t& anchor,
 
     switch (m_scanner.peek().type) {
       case Token::TAG:
-        ParseTag(tag);
+        ParseTag(pTag);
         break;
       case Token::ANCHOR:
-        ParseAnchor(anchor, anchor_name);
+        ParseAnchor(anchor, pAnchorName);
         break;
       default:
         return;
@@ -394,42 +455,53 @@ void SingleDocParser::ParseProperties(std::string& tag, anchor_t& anchor,
   }
 }
 
-void SingleDocParser::ParseTag(std::string& tag) {
+// ParseTag
+// . The tag is resolved through m_tags, which is what pTag is left pointing
+//   to.
+void SingleDocParser::ParseTag(const std::string*& pTag) {
   Token& token = m_scanner.peek();
-  if (!tag.empty())
+  if (pTag && !pTag->empty())
     throw ParserException(token.mark, ErrorMsg::MULTIPLE_TAGS);
 
-  Tag tagInfo(token);
-  tag = tagInfo.Translate(m_directives);
+  pTag = &m_tags.Resolve(token);
   m_scanner.pop();
 }
 
-void SingleDocParser::ParseAnchor(anchor_t& anchor, std::string& anchor_name) {
+// ParseAnchor
+// . The name the anchor is given is interned in m_anchors, which is what
+//   pAnchorName is left pointing to.
+void SingleDocParser::ParseAnchor(anchor_t& anchor,
+                                  const std::string*& pAnchorName) {
   Token& token = m_scanner.peek();
   if (anchor)
     throw ParserException(token.mark, ErrorMsg::MULTIPLE_ANCHORS);
 
-  anchor_name = token.value;
-  anchor = RegisterAnchor(token.value);
+  if (!token.value.empty()) {
+    if (m_anchors.AnchorCount() >= m_maxAnchors)
+      throw ParserException(token.mark, ErrorMsg::TOO_MANY_ANCHORS);
+    anchor = m_anchors.Register(token.value, pAnchorName);
+  }
   m_scanner.pop();
 }
 
-anchor_t SingleDocParser::RegisterAnchor(const std::string& name) {
-  if (name.empty())
-    return NullAnchor;
-
-  return m_anchors[name] = ++m_curAnchor;
-}
-
 anchor_t SingleDocParser::LookupAnchor(const Mark& mark,
-                                       const std::string& name) const {
-  auto it = m_anchors.find(name);
-  if (it == m_anchors.end()) {
+                                       const std::string& name) {
+  const anchor_t anchor = m_anchors.Lookup(name);
+  if (!anchor) {
     std::stringstream ss;
     ss << ErrorMsg::UNKNOWN_ANCHOR << name;
     throw ParserException(mark, ss.str());
   }
 
-  return it->second;
+  return anchor;
 }
+
+template void SingleDocParser::HandleDocument(EventHandler& eventHandler);
+template void SingleDocParser::HandleDocument(NodeBuilder& eventHandler);
+
+template void SingleDocParser::StartDocument(EventQueue& eventHandler);
+template void SingleDocParser::HandleNextState(EventQueue& eventHandler);
+template void SingleDocParser::EndDocument(EventQueue& eventHandler);
+template void SingleDocParser::HandleNextState(EventSkipper& eventHandler);
+template void SingleDocParser::EndDocument(EventSkipper& eventHandler);
 }  // namespace YAML
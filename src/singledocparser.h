@@ -7,64 +7,118 @@
 #pragma once
 #endif
 
-#include <map>
-#include <memory>
+#include <cstddef>
 #include <string>
+#include <vector>
 
+#include "anchortable.h"
+#include "tagtable.h"
 #include "yaml-cpp/anchor.h"
+#include "yaml-cpp/mark.h"
 
 namespace YAML {
-class CollectionStack;
-template <int> class DepthGuard; // depthguard.h
 class EventHandler;
 class Node;
 class Scanner;
 struct Directives;
-struct Mark;
 struct Token;
 
 class SingleDocParser {
  public:
-  SingleDocParser(Scanner& scanner, const Directives& directives);
+  SingleDocParser(Scanner& scanner, const Directives& directives,
+                  std::size_t maxDepth, std::size_t maxAnchors);
   SingleDocParser(const SingleDocParser&) = delete;
   SingleDocParser(SingleDocParser&&) = delete;
   SingleDocParser& operator=(const SingleDocParser&) = delete;
   SingleDocParser& operator=(SingleDocParser&&) = delete;
   ~SingleDocParser();
 
-  void HandleDocument(EventHandler& eventHandler);
+  // HandleDocument
+  // . Event calls are bound statically to Handler, which needs the same
+  //   member functions as EventHandler but need not derive from it.
+  // . Instantiated in singledocparser.cpp for EventHandler (the virtual
+  //   adapter behind Parser::HandleNextDocument), NodeBuilder, and the
+  //   handlers in eventqueue.h.
+  template <typename Handler>
+  void HandleDocument(Handler& eventHandler);
+
+  // The steps of HandleDocument, for callers that drive the parse one state
+  // at a time (see EventCursor): StartDocument, then HandleNextState while
+  // Depth() is non-zero, then EndDocument.
+  template <typename Handler>
+  void StartDocument(Handler& eventHandler);
+  template <typename Handler>
+  void HandleNextState(Handler& eventHandler);
+  template <typename Handler>
+  void EndDocument(Handler& eventHandler);
+
+  // the number of collections open at this point in the document
+  std::size_t Depth() const { return m_states.size(); }
 
  private:
-  void HandleNode(EventHandler& eventHandler);
+  // where to pick up in each open collection, once the node being parsed in
+  // it is done
+  struct State {
+    enum value {
+      BlockSeqEntry,
+      FlowSeqEntry,
+      FlowSeqSeparator,
+      BlockMapKey,
+      BlockMapValue,
+      FlowMapKey,
+      FlowMapValue,
+      FlowMapSeparator,
+      CompactMapValue,
+      CompactMapEnd
+    };
+  };
+
+  struct Frame {
+    State::value state;
+    Mark mark;  // of the current key, for an implicit null value
+  };
 
-  void HandleSequence(EventHandler& eventHandler);
-  void HandleBlockSequence(EventHandler& eventHandler);
-  void HandleFlowSequence(EventHandler& eventHandler);
+  template <typename Handler>
+  void StartNode(Handler& eventHandler);
+  void PushState(State::value state, const Mark& mark);
+  bool InFlowSequence() const;
 
-  void HandleMap(EventHandler& eventHandler);
-  void HandleBlockMap(EventHandler& eventHandler);
-  void HandleFlowMap(EventHandler& eventHandler);
-  void HandleCompactMap(EventHandler& eventHandler);
-  void HandleCompactMapWithNoKey(EventHandler& eventHandler);
+  template <typename Handler>
+  void HandleBlockSequenceEntry(Handler& eventHandler);
+  template <typename Handler>
+  void HandleFlowSequenceEntry(Handler& eventHandler);
+  void HandleFlowSequenceSeparator();
 
-  void ParseProperties(std::string& tag, anchor_t& anchor,
-                       std::string& anchor_name);
-  void ParseTag(std::string& tag);
-  void ParseAnchor(anchor_t& anchor, std::string& anchor_name);
+  template <typename Handler>
+  void StartCompactMap(Handler& eventHandler);
+  template <typename Handler>
+  void HandleBlockMapKey(Handler& eventHandler);
+  template <typename Handler>
+  void HandleBlockMapValue(Handler& eventHandler);
+  template <typename Handler>
+  void HandleFlowMapKey(Handler& eventHandler);
+  template <typename Handler>
+  void HandleFlowMapValue(Handler& eventHandler);
+  void HandleFlowMapSeparator();
+  template <typename Handler>
+  void HandleCompactMapValue(Handler& eventHandler);
 
-  anchor_t RegisterAnchor(const std::string& name);
-  anchor_t LookupAnchor(const Mark& mark, const std::string& name) const;
+  void ParseProperties(const std::string*& pTag, anchor_t& anchor,
+                       const std::string*& pAnchorName);
+  void ParseTag(const std::string*& pTag);
+  void ParseAnchor(anchor_t& anchor, const std::string*& pAnchorName);
+
+  anchor_t LookupAnchor(const Mark& mark, const std::string& name);
 
  private:
-  int depth = 0;
   Scanner& m_scanner;
   const Directives& m_directives;
-  std::unique_ptr<CollectionStack> m_pCollectionStack;
-
-  using Anchors = std::map<std::string, anchor_t>;
-  Anchors m_anchors;
+  std::size_t m_maxDepth;
+  std::vector<Frame> m_states;
 
-  anchor_t m_curAnchor;
+  std::size_t m_maxAnchors;
+  AnchorTable m_anchors;
+  TagTable m_tags;
 };
 }  // namespace YAML
 
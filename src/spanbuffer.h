@@ -0,0 +1,46 @@
+#ifndef SPANBUFFER_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define SPANBUFFER_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <streambuf>
+
+namespace YAML {
+// Reads a span of memory, after some other text (the directives that a span
+// of documents inherits), without copying either.
+class SpanBuffer : public std::streambuf {
+ public:
+  SpanBuffer(const char* prefix, std::size_t prefixSize, const char* data,
+             std::size_t size)
+      : m_pNext(data), m_nextSize(size) {
+    char* begin = const_cast<char*>(prefix);
+    setg(begin, begin, begin + prefixSize);
+  }
+  SpanBuffer(const SpanBuffer&) = delete;
+  SpanBuffer& operator=(const SpanBuffer&) = delete;
+
+ protected:
+  int_type underflow() override {
+    while (gptr() == egptr()) {
+      if (!m_pNext) {
+        return traits_type::eof();
+      }
+      char* begin = const_cast<char*>(m_pNext);
+      setg(begin, begin, begin + m_nextSize);
+      m_pNext = nullptr;
+    }
+    return traits_type::to_int_type(*gptr());
+  }
+
+ private:
+  const char* m_pNext;
+  std::size_t m_nextSize;
+};
+}  // namespace YAML
+
+#endif  // SPANBUFFER_H_62B23520_7C8E_11DE_8A39_0800200C9A66
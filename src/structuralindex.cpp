@@ -0,0 +1,89 @@
+#include "structuralindex.h"
+
+#include <algorithm>
+#include <exception>
+#include <thread>
+
+namespace YAML {
+const std::size_t StructuralIndex::MaxSize;
+
+namespace {
+const std::size_t BlockSize = 64;
+
+// below this much input per thread, another thread costs more than it saves
+const std::size_t MinBytesPerThread = std::size_t(16) << 20;
+
+// '[' and ']' are '{' and '}' but for the 0x20 bit
+inline unsigned char IsStructural(unsigned char ch) {
+  return static_cast<unsigned char>((ch < 0x20) | (ch == '"') | (ch == '\\') |
+                                    (ch == ',') | (ch == ':') |
+                                    ((ch | 0x20) == '{') |
+                                    ((ch | 0x20) == '}'));
+}
+
+// IndexRange
+// . Appends the offsets of the structural bytes in [begin, end) to
+//   positions. Each block is classified by a loop with no branches, and then
+//   compacted by another, which writes every offset but only keeps those
+//   that were flagged.
+void IndexRange(const char* input, std::size_t begin, std::size_t end,
+                std::vector<std::uint32_t>& positions) {
+  unsigned char flags[BlockSize];
+  std::uint32_t found[BlockSize];
+  for (std::size_t block = begin; block < end; block += BlockSize) {
+    const std::size_t length = std::min(BlockSize, end - block);
+    const unsigned char* text =
+        reinterpret_cast<const unsigned char*>(input + block);
+    for (std::size_t i = 0; i < length; i++)
+      flags[i] = IsStructural(text[i]);
+
+    std::size_t count = 0;
+    for (std::size_t i = 0; i < length; i++) {
+      found[count] = static_cast<std::uint32_t>(block + i);
+      count += flags[i];
+    }
+    positions.insert(positions.end(), found, found + count);
+  }
+}
+}  // namespace
+
+StructuralIndex::StructuralIndex(const char* input, std::size_t size)
+    : m_positions{} {
+  const std::size_t threads =
+      std::min<std::size_t>(std::max(1u, std::thread::hardware_concurrency()),
+                            size / MinBytesPerThread);
+  if (threads <= 1) {
+    IndexRange(input, 0, size, m_positions);
+    return;
+  }
+
+  // each thread takes a run of whole blocks, and the runs are joined in order
+  const std::size_t share =
+      (size / threads + BlockSize - 1) / BlockSize * BlockSize;
+  std::vector<std::vector<std::uint32_t>> parts(threads);
+  std::vector<std::exception_ptr> errors(threads);
+  auto work = [&](std::size_t i) {
+    try {
+      IndexRange(input, std::min(size, i * share),
+                 std::min(size, (i + 1) * share), parts[i]);
+    } catch (...) {
+      errors[i] = std::current_exception();
+    }
+  };
+
+  std::vector<std::thread> workers;
+  for (std::size_t i = 1; i < threads; i++)
+    workers.emplace_back(work, i);
+  work(0);
+  for (std::thread& worker : workers)
+    worker.join();
+
+  for (const std::exception_ptr& error : errors) {
+    if (error)
+      std::rethrow_exception(error);
+  }
+  m_positions = std::move(parts[0]);
+  for (std::size_t i = 1; i < threads; i++)
+    m_positions.insert(m_positions.end(), parts[i].begin(), parts[i].end());
+}
+}  // namespace YAML
@@ -0,0 +1,38 @@
+#ifndef STRUCTURALINDEX_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define STRUCTURALINDEX_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace YAML {
+// StructuralIndex
+// . The first stage of reading a document held in memory (see
+//   IndexedDocParser): the offsets of every byte the structure of a JSON
+//   document can turn on. Those are the brackets, braces, colons and commas,
+//   the quotes and backslashes that bound strings, and the control
+//   characters, line breaks included.
+// . Each block of input is classified without branching on its text, so
+//   the compiler can vectorize it, and a large input is split across
+//   threads, since no block depends on any other.
+class StructuralIndex {
+ public:
+  // the most input an index can cover, since a Mark's pos is an int
+  static const std::size_t MaxSize = 0x7fffffff;
+
+  StructuralIndex(const char* input, std::size_t size);
+
+  const std::vector<std::uint32_t>& positions() const { return m_positions; }
+
+ private:
+  std::vector<std::uint32_t> m_positions;
+};
+}  // namespace YAML
+
+#endif  // STRUCTURALINDEX_H_62B23520_7C8E_11DE_8A39_0800200C9A66
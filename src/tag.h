@@ -7,12 +7,7 @@
 #pragma once
 #endif
 
-#include <string>
-
 namespace YAML {
-struct Directives;
-struct Token;
-
 struct Tag {
   enum TYPE {
     VERBATIM,
@@ -21,12 +16,6 @@ struct Tag {
     NAMED_HANDLE,
     NON_SPECIFIC
   };
-
-  Tag(const Token& token);
-  std::string Translate(const Directives& directives);
-
-  TYPE type;
-  std::string handle, value;
 };
 }
 
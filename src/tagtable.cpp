@@ -0,0 +1,58 @@
+#include "tagtable.h"
+
+#include <cassert>
+
+#include "directives.h"
+#include "tag.h"
+#include "token.h"
+
+namespace YAML {
+TagTable::TagTable(const Directives& directives)
+    : m_directives(directives),
+      m_prefixes{},
+      m_tags{},
+      m_buffer{},
+      m_plain("?"),
+      m_nonPlain("!") {}
+
+const std::string& TagTable::Resolve(const Token& token) {
+  // first the handle goes in the buffer, which is then overwritten with its
+  // translation (which is kept elsewhere) and the suffix
+  const std::string* pSuffix = &token.value;
+  switch (static_cast<Tag::TYPE>(token.data)) {
+    case Tag::VERBATIM:
+      m_buffer = token.value;
+      return *m_tags.insert(m_buffer).first;
+    case Tag::PRIMARY_HANDLE:
+      m_buffer = "!";
+      break;
+    case Tag::SECONDARY_HANDLE:
+      m_buffer = "!!";
+      break;
+    case Tag::NAMED_HANDLE:
+      m_buffer.assign(1, '!').append(token.value).append(1, '!');
+      pSuffix = &token.params[0];
+      break;
+    case Tag::NON_SPECIFIC:
+      return m_nonPlain;
+    default:
+      assert(false);
+      break;
+  }
+
+  const std::string& prefix = Prefix(m_buffer);
+  m_buffer.assign(prefix).append(*pSuffix);
+  return *m_tags.insert(m_buffer).first;
+}
+
+// Prefix
+// . Translates the handle (with its '!'s) through the directives, and keeps
+//   the result for next time.
+const std::string& TagTable::Prefix(const std::string& handle) {
+  auto it = m_prefixes.find(handle);
+  if (it == m_prefixes.end())
+    it = m_prefixes.emplace(handle, m_directives.TranslateTagHandle(handle))
+             .first;
+  return it->second;
+}
+}  // namespace YAML
@@ -0,0 +1,51 @@
+#ifndef TAGTABLE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define TAGTABLE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace YAML {
+struct Directives;
+struct Token;
+
+// The tags resolved so far in a document. Each distinct tag is stored once,
+// here, and stays put for as long as the table does, so events can refer to
+// it rather than build it again; and each handle is only translated through
+// the directives the first time it's used.
+class TagTable {
+ public:
+  explicit TagTable(const Directives& directives);
+
+  TagTable(const TagTable&) = delete;
+  TagTable& operator=(const TagTable&) = delete;
+
+  // Resolve
+  // . Returns the full tag that the tag token stands for.
+  const std::string& Resolve(const Token& token);
+
+  // NonSpecific
+  // . Returns the tag given to a node that doesn't have one: "!" for a
+  //   quoted or block scalar, and "?" for anything else.
+  const std::string& NonSpecific(bool isNonPlainScalar) const {
+    return isNonPlainScalar ? m_nonPlain : m_plain;
+  }
+
+ private:
+  const std::string& Prefix(const std::string& handle);
+
+  const Directives& m_directives;
+  std::unordered_map<std::string, std::string> m_prefixes;
+  std::unordered_set<std::string> m_tags;
+  std::string m_buffer;  // where each tag is assembled before it's looked up
+  const std::string m_plain, m_nonPlain;
+};
+}  // namespace YAML
+
+#endif  // TAGTABLE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -0,0 +1,93 @@
+#ifndef TOKENQUEUE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define TOKENQUEUE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+#include "token.h"
+#include "yaml-cpp/mark.h"
+
+namespace YAML {
+// A queue of tokens that recycles them: a popped token goes back to a pool,
+// and a later push reuses it, with the storage its strings already have. So
+// once scanning has warmed up, queueing a token rarely allocates.
+// . A token stays at the same address for as long as it's queued, since the
+//   scanner's simple key and indent bookkeeping point at them.
+class TokenQueue {
+ public:
+  TokenQueue()
+      : m_pool{}, m_free{}, m_ring(16, nullptr), m_head(0), m_size(0) {}
+
+  TokenQueue(const TokenQueue&) = delete;
+  TokenQueue& operator=(const TokenQueue&) = delete;
+
+  bool empty() const { return m_size == 0; }
+  std::size_t size() const { return m_size; }
+
+  Token& front() { return *m_ring[m_head]; }
+  const Token& front() const { return *m_ring[m_head]; }
+  Token& back() {
+    return *m_ring[(m_head + m_size - 1) & (m_ring.size() - 1)];
+  }
+
+  // push
+  // . Queues a token of the given type, with an empty value and no params,
+  //   and returns it to be filled in.
+  Token& push(Token::TYPE type, const Mark& mark) {
+    if (m_size == m_ring.size())
+      Grow();
+
+    Token* pToken;
+    if (m_free.empty()) {
+      m_pool.emplace_back(new Token(type, mark));
+      pToken = m_pool.back().get();
+    } else {
+      pToken = m_free.back();
+      m_free.pop_back();
+      pToken->status = Token::VALID;
+      pToken->type = type;
+      pToken->mark = mark;
+      pToken->value.clear();
+      pToken->params.clear();
+      pToken->data = 0;
+    }
+
+    m_ring[(m_head + m_size) & (m_ring.size() - 1)] = pToken;
+    m_size++;
+    return *pToken;
+  }
+
+  void pop() {
+    m_free.push_back(m_ring[m_head]);
+    m_head = (m_head + 1) & (m_ring.size() - 1);
+    m_size--;
+  }
+
+ private:
+  // Grow
+  // . Doubles the ring (whose size is always a power of two); the tokens
+  //   themselves don't move.
+  void Grow() {
+    std::vector<Token*> ring(m_ring.size() * 2, nullptr);
+    for (std::size_t i = 0; i < m_size; i++)
+      ring[i] = m_ring[(m_head + i) & (m_ring.size() - 1)];
+    m_ring.swap(ring);
+    m_head = 0;
+  }
+
+  std::vector<std::unique_ptr<Token>> m_pool;  // every token, queued or not
+  std::vector<Token*> m_free;
+  std::vector<Token*> m_ring;
+  std::size_t m_head;
+  std::size_t m_size;
+};
+}  // namespace YAML
+
+#endif  // TOKENQUEUE_H_62B23520_7C8E_11DE_8A39_0800200C9A66
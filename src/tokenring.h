@@ -0,0 +1,76 @@
+#ifndef TOKENRING_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+#define TOKENRING_H_62B23520_7C8E_11DE_8A39_0800200C9A66
+
+#if defined(_MSC_VER) ||                                            \
+    (defined(__GNUC__) && (__GNUC__ == 3 && __GNUC_MINOR__ >= 4) || \
+     (__GNUC__ >= 4))  // GCC supports "pragma once" correctly since 3.4
+#pragma once
+#endif
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "token.h"
+#include "yaml-cpp/mark.h"
+
+namespace YAML {
+// A fixed-size queue of tokens passed from one producer thread to one
+// consumer thread without locking. Each side only writes its own index, and
+// publishes the slots it's done with by storing it.
+class TokenRing {
+ public:
+  explicit TokenRing(std::size_t capacity)
+      : m_slots(capacity + 1, Token(Token::PLAIN_SCALAR, Mark())),
+        m_head(0),
+        m_padding{},
+        m_tail(0) {}
+
+  TokenRing(const TokenRing&) = delete;
+  TokenRing& operator=(const TokenRing&) = delete;
+
+  // producer side
+  bool full() const {
+    const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+    return Next(tail) == m_head.load(std::memory_order_acquire);
+  }
+
+  // . Requires !full().
+  // . Swaps the token into the ring, leaving the caller with the one that
+  //   was in its slot, so both keep their strings' storage.
+  void push(Token& token) {
+    const std::size_t tail = m_tail.load(std::memory_order_relaxed);
+    std::swap(m_slots[tail], token);
+    m_tail.store(Next(tail), std::memory_order_release);
+  }
+
+  // consumer side
+  bool empty() const {
+    const std::size_t head = m_head.load(std::memory_order_relaxed);
+    return head == m_tail.load(std::memory_order_acquire);
+  }
+
+  // . Require !empty().
+  Token& front() { return m_slots[m_head.load(std::memory_order_relaxed)]; }
+  void pop() {
+    const std::size_t head = m_head.load(std::memory_order_relaxed);
+    m_head.store(Next(head), std::memory_order_release);
+  }
+
+ private:
+  std::size_t Next(std::size_t index) const {
+    return index + 1 == m_slots.size() ? 0 : index + 1;
+  }
+
+  // one slot is always left empty, to tell a full ring from an empty one;
+  // and the indices are padded onto separate cache lines, since each is
+  // written by a different thread
+  std::vector<Token> m_slots;
+  std::atomic<std::size_t> m_head;  // the next slot to read
+  char m_padding[64];
+  std::atomic<std::size_t> m_tail;  // the next slot to write
+};
+}  // namespace YAML
+
+#endif  // TOKENRING_H_62B23520_7C8E_11DE_8A39_0800200C9A66
@@ -71,6 +71,45 @@ TEST_F(EmitterTest, AliasScalar) {
   ExpectEmit("[&1 str, *1]");
 }
 
+TEST_F(EmitterTest, PushedTwiceIsAliased) {
+  Node element("str");
+  Node n;
+  n.push_back(element);
+  n.push_back(element);
+  out << Flow << n;
+  ExpectEmit("[&1 str, *1]");
+}
+
+TEST_F(EmitterTest, AssignedNodeIsAliased) {
+  Node n;
+  n["foo"] = "value";
+  n["bar"] = n["foo"];
+  out << Flow << n;
+  ExpectEmit("{foo: &1 value, bar: *1}");
+}
+
+TEST_F(EmitterTest, AssignedStandaloneNodeIsNotAliased) {
+  Node value(Load("[1, 2]"));
+  Node n;
+  n["foo"] = value;
+  n["bar"] = "other";
+  out << Flow << n;
+  ExpectEmit("{foo: [1, 2], bar: other}");
+}
+
+TEST_F(EmitterTest, SelfReferenceIsAliased) {
+  Node n;
+  n[0] = n;
+  out << Flow << n;
+  ExpectEmit("&1 [*1]");
+}
+
+TEST_F(EmitterTest, CycleThroughSubnodeIsAliased) {
+  Node n(Load("a: &1 {b: *1}"));
+  out << Flow << n["a"];
+  ExpectEmit("&1 {b: *1}");
+}
+
 TEST_F(EmitterTest, StringFormat) {
   out << BeginSeq;
   out.SetStringFormat(SingleQuoted);
@@ -1665,6 +1704,112 @@ TEST_F(EmitterTest, AnchorEncoding) {
   EXPECT_EQ(reparsed["--- &$ [*$]1"].as<int>(), 1);
 }
 
+class CompactJsonEmitterTest : public ::testing::Test {
+ protected:
+  CompactJsonEmitterTest() : out() { out.SetOutputFormat(CompactJson); }
+
+  void ExpectEmit(const std::string& expected) {
+    EXPECT_EQ(expected, out.c_str());
+    EXPECT_TRUE(out.good()) << "Emitter raised: " << out.GetLastError();
+  }
+
+  Emitter out;
+};
+
+TEST_F(CompactJsonEmitterTest, Scalars) {
+  out << BeginSeq << "foo" << 5 << -2.5 << true << false << Null << 'c'
+      << EndSeq;
+  ExpectEmit("[\"foo\",5,-2.5,true,false,null,\"c\"]");
+}
+
+TEST_F(CompactJsonEmitterTest, NestedGroups) {
+  out << BeginMap;
+  out << Key << "seq" << Value << BeginSeq << 1 << BeginMap << EndMap << EndSeq;
+  out << Key << "map" << Value << BeginMap << Key << "a" << Value << BeginSeq
+      << EndSeq << EndMap;
+  out << EndMap;
+  ExpectEmit("{\"seq\":[1,{}],\"map\":{\"a\":[]}}");
+}
+
+TEST_F(CompactJsonEmitterTest, KeysAreAlwaysQuoted) {
+  out << BeginMap << 1 << 2 << true << "x" << Null << 3.5 << "4" << "5"
+      << EndMap;
+  ExpectEmit("{\"1\":2,\"true\":\"x\",\"null\":3.5,\"4\":\"5\"}");
+}
+
+TEST_F(CompactJsonEmitterTest, StringEscaping) {
+  out << "a \"quoted\"\n\ttab \\ \x01 caf\xc3\xa9";
+  ExpectEmit("\"a \\\"quoted\\\"\\n\\ttab \\\\ \\u0001 caf\xc3\xa9\"");
+}
+
+TEST_F(CompactJsonEmitterTest, LiteralLookingStringsStayStrings) {
+  out << BeginSeq << "12" << "1e5" << "null" << "true" << DoubleQuoted << "12"
+      << EndSeq;
+  ExpectEmit("[\"12\",\"1e5\",\"null\",\"true\",\"12\"]");
+}
+
+TEST_F(CompactJsonEmitterTest, IgnoresYamlFormatting) {
+  out << Hex << Comment("hi") << BeginSeq << LocalTag("foo") << 255
+      << Anchor("a") << Block << BeginMap << EndMap << Newline << EndSeq;
+  ExpectEmit("[255,{}]");
+}
+
+TEST_F(CompactJsonEmitterTest, NonFiniteNumbers) {
+  out << BeginSeq << std::numeric_limits<double>::quiet_NaN()
+      << std::numeric_limits<double>::infinity() << EndSeq;
+  ExpectEmit("[null,null]");
+}
+
+TEST_F(CompactJsonEmitterTest, DanglingKey) {
+  out << BeginMap << "key" << EndMap;
+  ExpectEmit("{\"key\":null}");
+}
+
+TEST_F(CompactJsonEmitterTest, MultipleDocuments) {
+  out << BeginSeq << 1 << EndSeq << BeginDoc << "two" << EndDoc;
+  ExpectEmit("[1]\n\"two\"");
+}
+
+TEST_F(CompactJsonEmitterTest, Node) {
+  Node node = Load(
+      "{name: Barack Obama, age: 60, 'quoted': '7', tags: [!!str a, ~, true], "
+      "empty: {}}");
+  out << node;
+  ExpectEmit(
+      "{\"name\":\"Barack Obama\",\"age\":60,\"quoted\":\"7\","
+      "\"tags\":[\"a\",null,true],\"empty\":{}}");
+}
+
+TEST_F(CompactJsonEmitterTest, NodeScalarsKeepTheirType) {
+  Node node = Load("[7, '7', \"true\", true, !!str 8, 0x1F, 'null', -1.5e3]");
+  out << node;
+  ExpectEmit("[7,\"7\",\"true\",true,\"8\",\"0x1F\",\"null\",-1.5e3]");
+
+  Node reloaded = Load(out.c_str());
+  EXPECT_EQ("!", reloaded[1].Tag());
+  EXPECT_EQ("7", reloaded[1].as<std::string>());
+}
+
+TEST_F(CompactJsonEmitterTest, RoundTripsThroughParser) {
+  out << BeginMap << "list" << BeginSeq << 1 << "two" << 3.5 << EndSeq
+      << "flag" << false << EndMap;
+  ExpectEmit("{\"list\":[1,\"two\",3.5],\"flag\":false}");
+
+  Node node = Load(out.c_str());
+  EXPECT_EQ(3, node["list"].size());
+  EXPECT_EQ("two", node["list"][1].as<std::string>());
+  EXPECT_FALSE(node["flag"].as<bool>());
+}
+
+TEST_F(CompactJsonEmitterTest, FormatOnlyChangesBetweenNodes) {
+  out << BeginSeq;
+  EXPECT_FALSE(out.SetOutputFormat(Auto));
+  out << EndSeq;
+  EXPECT_TRUE(out.SetOutputFormat(Auto));
+  out << BeginSeq << "a" << EndSeq;
+  ExpectEmit("[]\n---\n- a");
+}
+
 class EmitterErrorTest : public ::testing::Test {
  protected:
   void ExpectEmitError(const std::string& expectedError) {
@@ -1728,6 +1873,27 @@ TEST_F(EmitterErrorTest, InvalidAnchor) {
   ExpectEmitError(ErrorMsg::INVALID_ANCHOR);
 }
 
+TEST_F(EmitterErrorTest, CompactJsonAlias) {
+  out.SetOutputFormat(CompactJson);
+  out << BeginSeq << Anchor("a") << "x" << Alias("a") << EndSeq;
+
+  ExpectEmitError(ErrorMsg::JSON_ALIAS);
+}
+
+TEST_F(EmitterErrorTest, CompactJsonCollectionKey) {
+  out.SetOutputFormat(CompactJson);
+  out << BeginMap << BeginSeq;
+
+  ExpectEmitError(ErrorMsg::JSON_KEY);
+}
+
+TEST_F(EmitterErrorTest, CompactJsonUnmatchedGroup) {
+  out.SetOutputFormat(CompactJson);
+  out << BeginSeq << EndMap;
+
+  ExpectEmitError(ErrorMsg::UNMATCHED_GROUP_TAG);
+}
+
 TEST_F(EmitterErrorTest, InvalidAlias) {
   out << BeginSeq;
   out << Alias("new\nline");
@@ -72,5 +72,36 @@ TEST_F(HandlerTest, CommentOnNewlineOfMapValueWithManySpace) {
   EXPECT_CALL(handler, OnDocumentEnd());
   Parse("key: value\n    # comment");
 }
+
+TEST_F(HandlerTest, Json) {
+  EXPECT_CALL(handler, OnDocumentStart(_));
+  EXPECT_CALL(handler, OnMapStart(_, "?", 0, EmitterStyle::Flow));
+  EXPECT_CALL(handler, OnScalar(_, "!", 0, "a"));
+  EXPECT_CALL(handler, OnSequenceStart(_, "?", 0, EmitterStyle::Flow));
+  EXPECT_CALL(handler, OnScalar(_, "?", 0, "-1.5e3"));
+  EXPECT_CALL(handler, OnScalar(_, "!", 0, "x y"));
+  EXPECT_CALL(handler, OnNull(_, 0));
+  EXPECT_CALL(handler, OnScalar(_, "?", 0, "true"));
+  EXPECT_CALL(handler, OnSequenceEnd());
+  EXPECT_CALL(handler, OnScalar(_, "!", 0, "b"));
+  EXPECT_CALL(handler, OnMapStart(_, "?", 0, EmitterStyle::Flow));
+  EXPECT_CALL(handler, OnMapEnd());
+  EXPECT_CALL(handler, OnMapEnd());
+  EXPECT_CALL(handler, OnDocumentEnd());
+  Parse("{\"a\":[-1.5e3,\"x y\",null,true],\n \"b\" : {}}");
+}
+
+TEST_F(HandlerTest, JsonLikeFlowScalars) {
+  EXPECT_CALL(handler, OnDocumentStart(_));
+  EXPECT_CALL(handler, OnSequenceStart(_, "?", 0, EmitterStyle::Flow));
+  EXPECT_CALL(handler, OnScalar(_, "?", 0, "a b"));
+  EXPECT_CALL(handler, OnScalar(_, "?", 0, "-"));
+  EXPECT_CALL(handler, OnScalar(_, "!", 0, "x\ty"));
+  EXPECT_CALL(handler, OnScalar(_, "!", 0, "two lines"));
+  EXPECT_CALL(handler, OnScalar(_, "?", 0, "1"));
+  EXPECT_CALL(handler, OnSequenceEnd());
+  EXPECT_CALL(handler, OnDocumentEnd());
+  Parse("[a b, -, \"x\\ty\", \"two\n lines\", 1\n]");
+}
 }  // namespace
 }  // namespace YAML
@@ -1,3 +1,5 @@
+#include <thread>
+
 #include "yaml-cpp/yaml.h"  // IWYU pragma: keep
 
 #include "gtest/gtest.h"
@@ -173,6 +175,35 @@ TEST(LoadNodeTest, CloneAlias) {
   EXPECT_EQ(clone[0], clone);
 }
 
+TEST(LoadNodeTest, RedefinedAnchor) {
+  Node node = Load("[&a 1, *a, &a 2, *a, &b 3, *b, *a]");
+  EXPECT_EQ(1, node[1].as<int>());
+  EXPECT_EQ(2, node[3].as<int>());
+  EXPECT_EQ(3, node[5].as<int>());
+  EXPECT_EQ(2, node[6].as<int>());
+  EXPECT_TRUE(node[6].is(node[2]));
+}
+
+TEST(LoadNodeTest, RepeatedTags) {
+  Node node = Load(
+      "%TAG !e! tag:example.com,2000:\n"
+      "---\n"
+      "[!e!a 1, !e!a 2, !e!b 3, !!int 4, !!int 5, !local 6, !<v> 7, 8, '9']");
+  EXPECT_EQ("tag:example.com,2000:a", node[0].Tag());
+  EXPECT_EQ("tag:example.com,2000:a", node[1].Tag());
+  EXPECT_EQ("tag:example.com,2000:b", node[2].Tag());
+  EXPECT_EQ("tag:yaml.org,2002:int", node[3].Tag());
+  EXPECT_EQ("tag:yaml.org,2002:int", node[4].Tag());
+  EXPECT_EQ("!local", node[5].Tag());
+  EXPECT_EQ("v", node[6].Tag());
+  EXPECT_EQ("?", node[7].Tag());
+  EXPECT_EQ("!", node[8].Tag());
+
+  node[1].SetTag("!other");
+  EXPECT_EQ("tag:example.com,2000:a", node[0].Tag());
+  EXPECT_EQ("!other", node[1].Tag());
+}
+
 TEST(LoadNodeTest, ForceInsertIntoMap) {
   Node node;
   node["a"] = "b";
@@ -360,5 +391,574 @@ TEST(LoadNodeTest, BlockCRNLEncoded) {
   EXPECT_EQ(1, node["followup"].as<int>());
 }
 
+TEST(LoadNodeTest, ScalarsWithIndicatorsInside) {
+  Node node = Load(
+      "plain: a:b c#d e-f  \n"
+      "flow: [a:b, c#d, 'it''s', \"x\\ty\"]\n"
+      "folded: >\n"
+      "  one: two\n"
+      "  three # four\n"
+      "end:x: y\n");
+  EXPECT_EQ("a:b c#d e-f", node["plain"].as<std::string>());
+  EXPECT_EQ("a:b", node["flow"][0].as<std::string>());
+  EXPECT_EQ("c#d", node["flow"][1].as<std::string>());
+  EXPECT_EQ("it's", node["flow"][2].as<std::string>());
+  EXPECT_EQ("x\ty", node["flow"][3].as<std::string>());
+  EXPECT_EQ("one: two three # four\n", node["folded"].as<std::string>());
+  EXPECT_EQ("y", node["end:x"].as<std::string>());
+}
+
+TEST(LoadNodeTest, JsonMarks) {
+  Node node = Load("{\"a\": [1, \"two\"],\n \"b\": 3}");
+  EXPECT_EQ(0, node["a"][0].Mark().line);
+  EXPECT_EQ(7, node["a"][0].Mark().column);
+  EXPECT_EQ(10, node["a"][1].Mark().column);
+  EXPECT_EQ(1, node["b"].Mark().line);
+  EXPECT_EQ(6, node["b"].Mark().column);
+  EXPECT_EQ(3, node["b"].as<int>());
+}
+
+TEST(LoadNodeTest, LoadSelectedKeyPath) {
+  Node node = LoadSelected(
+      "kind: Deployment\n"
+      "spec:\n"
+      "  replicas: 3\n"
+      "  template: {metadata: {name: web}, spec: [1, 2, 3]}\n",
+      {"spec.replicas"});
+  EXPECT_EQ(3, node["spec"]["replicas"].as<int>());
+  EXPECT_EQ(1, node.size());
+  EXPECT_EQ(1, node["spec"].size());
+}
+
+TEST(LoadNodeTest, LoadSelectedWholeSubtrees) {
+  Node node = LoadSelected("a: {b: [1, 2], c: 3}\nd: 4\n", {"$.a", "e"});
+  EXPECT_EQ(2, node["a"]["b"][1].as<int>());
+  EXPECT_EQ(3, node["a"]["c"].as<int>());
+  EXPECT_FALSE(node["d"]);
+
+  EXPECT_EQ(2, LoadSelected("[1, 2]", {""}).size());
+  EXPECT_EQ(2, LoadSelected("[1, 2]", {"$"}).size());
+  EXPECT_TRUE(LoadSelected("[1, 2]", {}).IsNull());
+}
+
+TEST(LoadNodeTest, LoadSelectedKeepsIndices) {
+  Node node = LoadSelected("items: [a, b, {name: c, size: 1}, d]",
+                           {"items[2].name"});
+  ASSERT_EQ(3, node["items"].size());
+  EXPECT_TRUE(node["items"][0].IsNull());
+  EXPECT_TRUE(node["items"][1].IsNull());
+  EXPECT_EQ("c", node["items"][2]["name"].as<std::string>());
+  EXPECT_FALSE(node["items"][2]["size"]);
+}
+
+TEST(LoadNodeTest, LoadSelectedWildcards) {
+  Node node = LoadSelected(
+      "- {name: a, size: 1}\n"
+      "- {name: b, size: 2}\n"
+      "- [name, c]\n",
+      {"[*].name"});
+  ASSERT_EQ(3, node.size());
+  EXPECT_EQ("a", node[0]["name"].as<std::string>());
+  EXPECT_EQ("b", node[1]["name"].as<std::string>());
+  EXPECT_FALSE(node[1]["size"]);
+  EXPECT_EQ(0, node[2].size());
+
+  node = LoadSelected("a: {x: 1, y: 2}\nb: {x: 3}\n", {"*.x"});
+  EXPECT_EQ(1, node["a"]["x"].as<int>());
+  EXPECT_EQ(3, node["b"]["x"].as<int>());
+  EXPECT_FALSE(node["a"]["y"]);
+}
+
+TEST(LoadNodeTest, LoadSelectedAliases) {
+  Node node = LoadSelected(
+      "skipped: &a 1\n"
+      "kept: &b 2\n"
+      "refs: [*a, *b]\n",
+      {"kept", "refs"});
+  EXPECT_FALSE(node["skipped"]);
+  EXPECT_EQ(2, node["kept"].as<int>());
+  EXPECT_TRUE(node["refs"][0].IsNull());
+  EXPECT_EQ(2, node["refs"][1].as<int>());
+  EXPECT_TRUE(node["refs"][1].is(node["kept"]));
+}
+
+TEST(LoadNodeTest, LoadSelectedBadPath) {
+  for (const char* path : {"a..b", "a.", "$a", "a[]", "a[0"}) {
+    EXPECT_THROW(LoadSelected("a: 1", {path}), BadPath) << path;
+  }
+}
+
+TEST(LoadNodeTest, LoadSelectedStillChecksSkippedParts) {
+  EXPECT_THROW(LoadSelected("a: 1\nb: [*unknown]\n", {"a"}),
+               ParserException);
+}
+
+TEST(LoadNodeTest, DocumentStreamIterates) {
+  std::stringstream input("a\n--- [b]\n--- {c: d}\n");
+  std::vector<Node> docs;
+  for (const Node& doc : DocumentStream(input)) {
+    docs.push_back(doc);
+  }
+  ASSERT_EQ(3, docs.size());
+  EXPECT_EQ("a", docs[0].as<std::string>());
+  EXPECT_EQ("b", docs[1][0].as<std::string>());
+  EXPECT_EQ("d", docs[2]["c"].as<std::string>());
+}
+
+TEST(LoadNodeTest, DocumentStreamNext) {
+  std::stringstream input("1\n--- 2\n");
+  DocumentStream stream(input);
+  EXPECT_TRUE(stream.current().IsNull());
+
+  ASSERT_TRUE(stream.Next());
+  Node first = stream.current();
+  ASSERT_TRUE(stream.Next());
+  EXPECT_EQ(2, stream.current().as<int>());
+  // loading the next document leaves the last one alone
+  EXPECT_EQ(1, first.as<int>());
+
+  EXPECT_FALSE(stream.Next());
+  EXPECT_TRUE(stream.current().IsNull());
+  EXPECT_FALSE(stream.Next());
+  EXPECT_EQ(stream.end(), stream.begin());
+}
+
+TEST(LoadNodeTest, DocumentStreamEmpty) {
+  std::stringstream input("");
+  DocumentStream stream(input);
+  EXPECT_EQ(stream.end(), stream.begin());
+}
+
+TEST(LoadNodeTest, DocumentStreamIsLazy) {
+  // the malformed second document is only read when asked for
+  std::stringstream input("a\n--- [b\n");
+  DocumentStream stream(input);
+  auto it = stream.begin();
+  EXPECT_EQ("a", it->as<std::string>());
+  EXPECT_THROW(++it, ParserException);
+}
+
+void ExpectSameDocuments(const std::vector<Node>& expected,
+                         const std::vector<Node>& actual) {
+  ASSERT_EQ(expected.size(), actual.size());
+  for (std::size_t i = 0; i < expected.size(); i++) {
+    EXPECT_EQ(Dump(expected[i]), Dump(actual[i])) << i;
+    EXPECT_EQ(expected[i].Tag(), actual[i].Tag()) << i;
+    EXPECT_EQ(expected[i].Mark().pos, actual[i].Mark().pos) << i;
+    EXPECT_EQ(expected[i].Mark().line, actual[i].Mark().line) << i;
+    EXPECT_EQ(expected[i].Mark().column, actual[i].Mark().column) << i;
+  }
+}
+
+TEST(LoadNodeTest, LoadAllParallelMatchesLoadAll) {
+  std::string input = "%TAG !e! tag:example.com,2000:\n";
+  for (int i = 0; i < 4000; i++) {
+    input += "--- !e!doc\n";
+    input += "id: " + std::to_string(i) + "\n";
+    input += "text: |\n  ---\n  ...\n";
+    input += "quoted: \"a\n  b\"\n";
+    input += "list: [1, 2, {x: &a y}, *a]\n";
+    if (i % 3 == 0) {
+      input += "...\n# comment\n";
+    }
+    if (i % 1000 == 999) {
+      input += "%TAG !e! tag:other.com,2000:\n";
+    }
+  }
+
+  ExpectSameDocuments(LoadAll(input), LoadAllParallel(input, 4));
+}
+
+TEST(LoadNodeTest, LoadAllParallelImplicitDocuments) {
+  std::string input;
+  for (int i = 0; i < 20000; i++) {
+    input += "[" + std::to_string(i) + "]\n...\n...\n{a: b}\n";
+  }
+
+  ExpectSameDocuments(LoadAll(input), LoadAllParallel(input, 3));
+}
+
+TEST(LoadNodeTest, LoadAllParallelFallsBack) {
+  // a "%" line after a plain scalar continues it
+  std::string input;
+  for (int i = 0; i < 20000; i++) {
+    input += "--- a\n%b\n";
+  }
+
+  ExpectSameDocuments(LoadAll(input), LoadAllParallel(input, 4));
+  EXPECT_EQ("a %b", LoadAllParallel(input, 4)[0].as<std::string>());
+}
+
+TEST(LoadNodeTest, LoadAllParallelThrowsFirstError) {
+  std::string input;
+  for (int i = 0; i < 20000; i++) {
+    input += "--- [a, b]\n";
+    if (i == 12345 || i == 17000) {
+      input += "--- [a, *unknown]\n";
+    }
+  }
+
+  Mark expected;
+  try {
+    LoadAll(input);
+    FAIL() << "LoadAll did not throw";
+  } catch (const ParserException& e) {
+    expected = e.mark;
+  }
+
+  try {
+    LoadAllParallel(input, 4);
+    FAIL() << "LoadAllParallel did not throw";
+  } catch (const ParserException& e) {
+    EXPECT_EQ(expected.pos, e.mark.pos);
+    EXPECT_EQ(expected.line, e.mark.line);
+    EXPECT_EQ(expected.column, e.mark.column);
+  }
+}
+
+TEST(LoadNodeTest, LoadPipelinedMatchesLoad) {
+  std::string input;
+  for (int i = 0; i < 5000; i++) {
+    const std::string id = std::to_string(i);
+    input += "k" + id + ": &a" + id + " [" + id + ", \"x\\ty\", {z: *a" +
+             id + "}]\n";
+  }
+
+  std::stringstream stream(input);
+  Node expected = Load(input);
+  Node actual = LoadPipelined(stream);
+  EXPECT_EQ(Dump(expected), Dump(actual));
+  EXPECT_EQ(expected["k4321"][1].Mark().pos, actual["k4321"][1].Mark().pos);
+  EXPECT_EQ(expected["k4321"][1].Mark().line, actual["k4321"][1].Mark().line);
+}
+
+TEST(LoadNodeTest, LoadPipelinedThrowsScannerError) {
+  std::string input;
+  for (int i = 0; i < 5000; i++) {
+    input += "- [a, b]\n";
+  }
+  input += "- [a, }\n";
+
+  Mark expected;
+  try {
+    Load(input);
+    FAIL() << "Load did not throw";
+  } catch (const ParserException& e) {
+    expected = e.mark;
+  }
+
+  std::stringstream stream(input);
+  try {
+    LoadPipelined(stream);
+    FAIL() << "LoadPipelined did not throw";
+  } catch (const ParserException& e) {
+    EXPECT_EQ(expected.pos, e.mark.pos);
+    EXPECT_EQ(expected.line, e.mark.line);
+  }
+}
+
+TEST(LoadNodeTest, LoadPipelinedOnlyFirstDocument) {
+  // the scanner may run ahead into the rest, but doesn't hold up returning
+  std::string input = "first\n";
+  for (int i = 0; i < 20000; i++) {
+    input += "--- [a, b]\n";
+  }
+  input += "--- [unterminated\n";
+
+  std::stringstream stream(input);
+  EXPECT_EQ("first", LoadPipelined(stream).as<std::string>());
+}
+
+// the sequence's elements, or nothing if any doesn't convert
+template <typename T>
+std::pair<bool, std::vector<T>> Elements(const Node& node) {
+  try {
+    return {true, node.as<std::vector<T>>()};
+  } catch (const BadConversion&) {
+    return {false, {}};
+  }
+}
+
+TEST(LoadNodeTest, LoadPackedMatchesLoad) {
+  const std::vector<std::string> inputs = {
+      "[1, 2, 3]",
+      "[0.1, -2, 3e5, .5, +1., 1E-3, 9223372036854775807]",
+      "- -9223372036854775808\n- 9223372036854775808\n- 2\n",
+      "[-0, 0, 010, 1e400]",
+      "[1, [2, 3], {a: 4}]",
+      "{a: [1, 2], [3, 4]: b}",
+      "[1, ~, 2]",
+      "[1, &a 2, *a]",
+      "&a [1, 2]",
+      "[1, !!int 2, '3', 0x10, .inf]",
+      "[1, 300, -1]",
+      "[]"};
+  for (const std::string& input : inputs) {
+    const Node expected = Load(input);
+    const Node actual = LoadPacked(input);
+    EXPECT_EQ(Dump(expected), Dump(actual)) << input;
+    EXPECT_EQ(expected.size(), actual.size()) << input;
+    if (expected.IsSequence()) {
+      EXPECT_EQ(Elements<std::string>(expected), Elements<std::string>(actual))
+          << input;
+      EXPECT_EQ(Elements<double>(expected), Elements<double>(actual)) << input;
+      EXPECT_EQ(Elements<long long>(expected), Elements<long long>(actual))
+          << input;
+      EXPECT_EQ(Elements<float>(expected), Elements<float>(actual)) << input;
+      EXPECT_EQ(Elements<unsigned char>(expected),
+                Elements<unsigned char>(actual))
+          << input;
+    }
+  }
+
+  // a sequence that turns out not to be all numbers keeps every mark
+  const Node expected = Load("[1, 2, x]");
+  const Node actual = LoadPacked("[1, 2, x]");
+  EXPECT_EQ(expected[1].Mark().pos, actual[1].Mark().pos);
+  EXPECT_EQ(expected[2].Mark().pos, actual[2].Mark().pos);
+}
+
+TEST(LoadNodeTest, LoadPackedReadsLikeSequence) {
+  Node node = LoadPacked("values: [1.5, 2, -3]\ncount: 3\n");
+  EXPECT_TRUE(node["values"].IsSequence());
+  EXPECT_EQ(3, node["values"].size());
+  EXPECT_EQ(std::vector<double>({1.5, 2, -3}),
+            node["values"].as<std::vector<double>>());
+  EXPECT_THROW(node["values"].as<std::vector<int>>(),
+               TypedBadConversion<int>);
+  EXPECT_EQ("2", Freeze(node).root()["values"][1].Scalar());
+
+  int sum = 0;
+  for (const auto& element : node["values"])
+    sum += element.as<int>(0);
+  EXPECT_EQ(-1, sum);
+  EXPECT_EQ(node["values"].Mark().pos, node["values"][0].Mark().pos);
+  EXPECT_EQ(node["values"][2], node["values"][2]);
+
+  node["values"].push_back(4);
+  node["values"][0] = "x";
+  EXPECT_EQ("values: [x, 2, -3, 4]\ncount: 3", Dump(node));
+}
+
+TEST(LoadNodeTest, LoadPackedConstReadsLeaveItPacked) {
+  std::string input = "[";
+  for (int i = 0; i < 1000; i++)
+    input += (i > 0 ? ", " : "") + std::to_string(i);
+  const Node node = LoadPacked(input + "]");
+
+  EXPECT_EQ("7", node[7].Scalar());
+  EXPECT_EQ("?", node[7].Tag());
+  EXPECT_EQ(node.Mark().pos, node[7].Mark().pos);
+  EXPECT_FALSE(node[1000]);
+  EXPECT_FALSE(node[-1]);
+  EXPECT_FALSE(node["7"]);
+  EXPECT_EQ(1000, std::distance(node.begin(), node.end()));
+
+  std::vector<std::thread> readers;
+  std::vector<int> sums(4, 0);
+  for (std::size_t t = 0; t < sums.size(); t++) {
+    readers.emplace_back([&node, &sums, t] {
+      for (const auto& element : node)
+        sums[t] += element.as<int>();
+      for (std::size_t i = 0; i < node.size(); i++)
+        sums[t] -= node[i].as<int>();
+    });
+  }
+  for (std::thread& reader : readers)
+    reader.join();
+  for (int sum : sums)
+    EXPECT_EQ(0, sum);
+  EXPECT_NE(nullptr, detail::packed_access::packed(node));
+
+  // a non-const read unpacks it
+  Node mutableNode = node;
+  EXPECT_EQ("7", mutableNode[7].Scalar());
+  EXPECT_EQ(nullptr, detail::packed_access::packed(node));
+}
+
+TEST(LoadNodeTest, LoadPackedIteratorsKeepTheDocument) {
+  const_iterator it, end;
+  {
+    const Node node = LoadPacked("[1, 2, 3]");
+    it = node.begin();
+    end = node.end();
+  }
+  int sum = 0;
+  for (; it != end; ++it)
+    sum += it->as<int>();
+  EXPECT_EQ(6, sum);
+}
+
+TEST(LoadNodeTest, FreezeReadsLikeNode) {
+  const std::string input =
+      "b: [1, 2, {c: d}]\na: !t 3\n? [x]\n: y\na: 4\nz: ~\n0: zero\n";
+  Node node = Load(input);
+  FrozenDocument frozen = Freeze(node);
+  node["b"] = "changed";
+
+  FrozenNode root = frozen.root();
+  ASSERT_TRUE(root.IsMap());
+  EXPECT_EQ(6, root.size());
+  EXPECT_EQ(3, root["a"].as<int>());
+  EXPECT_EQ("!t", root["a"].Tag());
+  EXPECT_EQ(3, root["b"].size());
+  EXPECT_EQ(2, root["b"][1].as<int>());
+  EXPECT_EQ("d", root["b"][2]["c"].as<std::string>());
+  EXPECT_TRUE(root["z"].IsNull());
+  EXPECT_EQ("zero", root[0].as<std::string>());
+  EXPECT_FALSE(root["missing"]);
+  EXPECT_FALSE(root["b"][3]);
+  EXPECT_FALSE(root["a"]["a"]);
+  EXPECT_EQ(7, root["missing"].as<int>(7));
+  EXPECT_THROW(root["b"].as<int>(), TypedBadConversion<int>);
+
+  std::vector<std::string> keys;
+  for (auto element : root)
+    keys.push_back(element.first.IsScalar() ? element.first.Scalar() : "?");
+  EXPECT_EQ((std::vector<std::string>{"b", "a", "?", "a", "z", "0"}), keys);
+  EXPECT_EQ(Dump(Load(input)), Dump(root.Thaw()));
+}
+
+TEST(LoadNodeTest, FreezeConvertsScalarsLikeNode) {
+  const Node node = Load(
+      "[12, -1, 0x1F, 010, 1e3, .inf, -.Inf, yes, Off, abc, 300, '7', ~]");
+  const FrozenDocument frozen = Freeze(node);
+  for (std::size_t i = 0; i < node.size(); i++) {
+    const FrozenNode element = frozen.root()[i];
+    EXPECT_EQ(node[i].as<int>(-2), element.as<int>(-2)) << i;
+    EXPECT_EQ(node[i].as<unsigned char>('x'), element.as<unsigned char>('x'))
+        << i;
+    EXPECT_EQ(node[i].as<double>(0.5), element.as<double>(0.5)) << i;
+    EXPECT_EQ(node[i].as<bool>(false), element.as<bool>(false)) << i;
+    EXPECT_EQ(node[i].as<std::string>("-"), element.as<std::string>("-"))
+        << i;
+    EXPECT_EQ(node[i].as<std::string>(), element.as<std::string>()) << i;
+  }
+  EXPECT_EQ(31, frozen.root()[2].as<int>());
+  EXPECT_TRUE(frozen.root()[7].as<bool>());
+  EXPECT_THROW(frozen.root()[9].as<int>(), TypedBadConversion<int>);
+  EXPECT_THROW(frozen.root()[10].as<unsigned char>(),
+               TypedBadConversion<unsigned char>);
+  EXPECT_THROW(frozen.root().as<bool>(), TypedBadConversion<bool>);
+}
+
+TEST(LoadNodeTest, FreezeKeepsAliases) {
+  Node node = Load("a: &x {b: [1, 2]}\nc: *x\nd: *x\n");
+  FrozenDocument frozen = Freeze(node);
+  // the root, its three keys, and the aliased map, with b: [1, 2] in it
+  EXPECT_EQ(9, frozen.NodeCount());
+  EXPECT_TRUE(frozen.root()["a"].is(frozen.root()["d"]));
+
+  Node thawed = frozen.root().Thaw();
+  EXPECT_TRUE(thawed["a"].is(thawed["c"]));
+  EXPECT_EQ(Dump(node), Dump(thawed));
+
+  Node cycle;
+  cycle["self"] = cycle;
+  FrozenDocument frozenCycle = Freeze(cycle);
+  EXPECT_TRUE(frozenCycle.root()["self"]["self"].is(frozenCycle.root()));
+}
+
+TEST(LoadNodeTest, FreezeKeepsViewsAcrossMoves) {
+  FrozenDocument frozen = Freeze(Load("a: {b: [1, 2]}"));
+  const FrozenNode b = frozen.root()["a"]["b"];
+
+  FrozenDocument moved = std::move(frozen);
+  EXPECT_EQ(2, b.size());
+  EXPECT_EQ(2, b[1].as<int>());
+  EXPECT_TRUE(b.is(moved.root()["a"]["b"]));
+
+  FrozenDocument assigned;
+  assigned = std::move(moved);
+  EXPECT_EQ("1", b[0].Scalar());
+  EXPECT_EQ(0, moved.NodeCount());
+}
+
+TEST(LoadNodeTest, FreezeReadsConcurrently) {
+  std::string input;
+  for (int i = 0; i < 1000; i++)
+    input += "k" + std::to_string(i) + ": {value: " + std::to_string(i) + "}\n";
+  const FrozenDocument frozen = Freeze(Load(input));
+
+  std::vector<std::thread> readers;
+  std::vector<int> sums(8, 0);
+  for (std::size_t t = 0; t < sums.size(); t++) {
+    readers.emplace_back([&frozen, &sums, t] {
+      for (int i = 0; i < 1000; i++)
+        sums[t] += frozen.root()["k" + std::to_string(i)]["value"].as<int>();
+    });
+  }
+  for (std::thread& reader : readers)
+    reader.join();
+  for (int sum : sums)
+    EXPECT_EQ(499500, sum);
+}
+
+TEST(LoadNodeTest, LazyDocumentMatchesLoad) {
+  const std::string input =
+      "# config\n"
+      "name: test\n"
+      "server:\n"
+      "  host: \"example.com\"  # comment\n"
+      "  ports:\n"
+      "  - 80\n"
+      "  - 443\n"
+      "  'tls': {cert: a,\n    key: b}\n"
+      "banner: !!binary |\n"
+      " R0lGODlhDAAMAIQAAP\n"
+      "empty:\n"
+      "last: plain\n"
+      "  continued\n";
+  const Node expected = Load(input);
+  LazyDocument document(input);
+  const LazyNode root = document.root();
+  EXPECT_EQ(5, root.size());
+  EXPECT_TRUE(root["server"].IsMap());
+  EXPECT_EQ("example.com", root["server"]["host"].as<std::string>());
+  EXPECT_EQ(443, root["server"]["ports"][1].as<int>());
+  EXPECT_EQ("b", root["server"]["tls"]["key"].as<std::string>());
+  EXPECT_TRUE(root["empty"].IsNull());
+  EXPECT_EQ("plain continued", root["last"].as<std::string>());
+  EXPECT_FALSE(root["missing"]);
+  EXPECT_FALSE(root["server"]["missing"]);
+
+  const Node port = root["server"]["ports"][1].node();
+  EXPECT_EQ(expected["server"]["ports"][1].Mark().line, port.Mark().line);
+  EXPECT_EQ(expected["server"]["ports"][1].Mark().column, port.Mark().column);
+  EXPECT_EQ(expected["server"]["ports"][1].Mark().pos, port.Mark().pos);
+  EXPECT_EQ(expected["banner"].Scalar(), root["banner"].as<std::string>());
+  EXPECT_EQ(expected["empty"].Mark().pos, root["empty"].node().Mark().pos);
+  EXPECT_EQ(Dump(expected), Dump(root.node()));
+  EXPECT_TRUE(root["server"].node().is(root.node()["server"]));
+}
+
+TEST(LoadNodeTest, LazyDocumentParsesOnlyWhatIsUsed) {
+  const std::string input = "a: 1\nb: \"\\q\"\nc:\n  d: 2\n";
+  LazyDocument document(input);
+  EXPECT_EQ(1, document.root()["a"].as<int>());
+  EXPECT_EQ(2, document.root()["c"]["d"].as<int>());
+  EXPECT_EQ(3, document.root().size());
+
+  try {
+    document.root()["b"].as<std::string>();
+    FAIL() << "parsing b did not throw";
+  } catch (const ParserException& e) {
+    EXPECT_EQ(1, e.mark.line);
+  }
+}
+
+TEST(LoadNodeTest, LazyDocumentFallsBack) {
+  // an alias, or a document that isn't a map, is parsed in full; errors
+  // in a value are thrown once it is
+  LazyDocument aliases("a: &x 1\nb: *x\n");
+  EXPECT_EQ(1, aliases.root()["b"].as<int>());
+  LazyDocument sequence("- a\n- b\n");
+  EXPECT_EQ("b", sequence.root()[1].as<std::string>());
+  LazyDocument indented("a: 1\n  b: 2\n");
+  EXPECT_THROW(indented.root()["a"].as<int>(), ParserException);
+  LazyDocument empty("");
+  EXPECT_TRUE(empty.root().IsNull());
+}
+
 }  // namespace
 }  // namespace YAML
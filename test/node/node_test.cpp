@@ -9,7 +9,10 @@
 #include "gmock/gmock.h"
 #include "gtest/gtest.h"
 
+#include <atomic>
 #include <sstream>
+#include <thread>
+#include <vector>
 
 namespace {
 
@@ -184,6 +187,56 @@ TEST(NodeTest, EqualRepresentationAfterMoveAssignment) {
   EXPECT_EQ(ss1.str(), ss2.str());
 }
 
+TEST(NodeTest, MoveConstruction) {
+  Node node1;
+  node1["foo"] = "bar";
+  Node node2(std::move(node1));
+  EXPECT_EQ("bar", node2["foo"].as<std::string>());
+  EXPECT_TRUE(node1.IsNull());
+
+  const Node& constNode = node2;
+  Node invalid = constNode["missing"];
+  Node moved(std::move(invalid));
+  EXPECT_FALSE(moved.IsDefined());
+  EXPECT_THROW(moved.Type(), InvalidNode);
+}
+
+TEST(NodeTest, HandleIsTwoPointers) {
+  EXPECT_EQ(sizeof(detail::shared_memory_holder) + sizeof(detail::node*),
+            sizeof(Node));
+}
+
+TEST(NodeTest, InvalidNodeCopiesKeepKey) {
+  const Node node(NodeType::Map);
+  Node missing = node["missing"];
+  Node copy = missing;
+  Node moved(std::move(missing));
+  for (const Node& invalid : {copy, moved}) {
+    EXPECT_FALSE(invalid.IsDefined());
+    try {
+      invalid.as<int>();
+      FAIL() << "expected InvalidNode";
+    } catch (const InvalidNode& e) {
+      EXPECT_NE(std::string::npos, std::string(e.what()).find("missing"));
+    }
+  }
+}
+
+TEST(NodeTest, MoveAssignmentIntoChild) {
+  Node node;
+  node["foo"] = "bar";
+  Node other;
+  other["baz"] = "qux";
+  node["foo"] = std::move(other);
+  EXPECT_TRUE(node["foo"].IsMap());
+  EXPECT_EQ("qux", node["foo"]["baz"].as<std::string>());
+
+  Node fresh;
+  Node child = node["foo"];
+  fresh = std::move(child);
+  EXPECT_EQ(node["foo"], fresh);
+}
+
 TEST(NodeTest, MapElementRemoval) {
   Node node;
   node["foo"] = "bar";
@@ -235,6 +288,20 @@ TEST(NodeTest, MapWithUndefinedValues) {
   EXPECT_EQ(2, node.size());
 }
 
+TEST(NodeTest, DefiningNestedUndefinedValues) {
+  Node node;
+  Node inner = node["outer"]["inner"];
+  for (int i = 0; i < 3; i++)
+    node["outer"]["inner"];
+  EXPECT_EQ(0, node.size());
+
+  inner = "value";
+  EXPECT_TRUE(node.IsMap());
+  EXPECT_EQ(1, node.size());
+  EXPECT_EQ(1, node["outer"].size());
+  EXPECT_EQ("value", node["outer"]["inner"].as<std::string>());
+}
+
 TEST(NodeTest, SeqIntoMap) {
   Node node;
   node[0] = "test";
@@ -246,6 +313,32 @@ TEST(NodeTest, SeqIntoMap) {
   EXPECT_EQ(2, node.size());
 }
 
+TEST(NodeTest, ChangingTypeReplacesContents) {
+  Node node;
+  node.push_back(1);
+  EXPECT_TRUE(node.IsSequence());
+  EXPECT_EQ(1, node.size());
+
+  node["key"] = "value";
+  EXPECT_TRUE(node.IsMap());
+  EXPECT_EQ(2, node.size());
+  EXPECT_EQ(1, node[0].as<int>());
+
+  node = Null;
+  EXPECT_TRUE(node.IsNull());
+  EXPECT_EQ(0, node.size());
+
+  node[0] = "first";
+  EXPECT_TRUE(node.IsSequence());
+  EXPECT_EQ(1, node.size());
+
+  node = "scalar";
+  EXPECT_TRUE(node.IsScalar());
+  EXPECT_EQ("scalar", node.Scalar());
+  EXPECT_EQ(0, node.size());
+  EXPECT_THROW(node.push_back(1), BadPushback);
+}
+
 TEST(NodeTest, RemoveUnassignedNode) {
   Node node(NodeType::Map);
   node["key"];
@@ -607,6 +700,23 @@ TEST(NodeTest, TempMapVariableAlias) {
   EXPECT_EQ(node["key"], node["other"]);
 }
 
+TEST(NodeTest, AliasOutlivesTheNodeItRefersTo) {
+  Node node;
+  {
+    Node other;
+    other["a"].push_back(1);
+    other["a"].push_back(2);
+    node["alias"] = other["a"];
+    node["copy"] = other;
+    other["a"].push_back(3);
+  }
+  EXPECT_EQ(3, node["alias"].size());
+  EXPECT_EQ(node["alias"], node["copy"]["a"]);
+
+  node["alias"].push_back(4);
+  EXPECT_EQ(4, node["copy"]["a"].size());
+}
+
 TEST(NodeTest, Bool) {
   Node node;
   node[true] = false;
@@ -725,6 +835,144 @@ TEST(NodeTest, AccessNonexistentKeyOnConstNode) {
   ASSERT_FALSE(other["5"]);
 }
 
+TEST(NodeTest, CachedScalarFollowsChanges) {
+  Node node("3.5");
+  EXPECT_THROW(node.as<int>(), TypedBadConversion<int>);
+  EXPECT_EQ(3.5, node.as<double>());
+  EXPECT_EQ(3.5, node.as<double>());
+  EXPECT_EQ(3.5f, node.as<float>());
+  EXPECT_EQ(7, node.as<int>(7));
+
+  Node alias = node;
+  node = "42";
+  EXPECT_EQ(42, alias.as<int>());
+  EXPECT_EQ(42, node.as<int>());
+  EXPECT_EQ(42.0, node.as<double>());
+  EXPECT_EQ("42", node.as<std::string>());
+
+  node = "yes";
+  EXPECT_TRUE(alias.as<bool>());
+  EXPECT_EQ(7, node.as<int>(7));
+
+  node = Node(NodeType::Sequence);
+  node.push_back(1);
+  EXPECT_THROW(node.as<bool>(), TypedBadConversion<bool>);
+  EXPECT_EQ(1, node[0].as<int>());
+}
+
+TEST(NodeTest, CachedScalarReadsConcurrently) {
+  Node sequence;
+  for (int i = 0; i < 64; i++)
+    sequence.push_back(std::to_string(i));
+  const Node& node = sequence;
+
+  std::atomic<int> mismatches(0);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; t++) {
+    threads.emplace_back([&, t] {
+      for (int round = 0; round < 100; round++) {
+        for (int i = 0; i < 64; i++) {
+          const bool ok = (t % 2 == 0) ? node[i].as<int>() == i
+                                       : node[i].as<long>() == i;
+          if (!ok)
+            mismatches++;
+        }
+      }
+    });
+  }
+  for (auto& thread : threads)
+    thread.join();
+  EXPECT_EQ(0, mismatches);
+}
+
+TEST(NodeTest, CollectGarbageKeepsWhatIsReachable) {
+  Node node;
+  node["a"]["b"] = 1;
+  node["list"].push_back(2);
+  node["self"] = node;
+  Node list = node["list"];
+  node.remove("list");
+  const std::string before = Dump(node);
+
+  CollectGarbage(node);
+  EXPECT_EQ(0, CollectGarbage(node));
+  EXPECT_EQ(before, Dump(node));
+  EXPECT_EQ(1, node["self"]["a"]["b"].as<int>());
+  list.push_back(3);
+  EXPECT_EQ(3, list[1].as<int>());
+}
+
+TEST(NodeTest, CollectGarbageKeepsMergedHandles) {
+  // sub's own node is replaced by a reference to the config's copy, so the
+  // config doesn't reach it, but sub still refers to it
+  Node config;
+  Node sub;
+  sub["k"] = 1;
+  config["sub"] = sub;
+  CollectGarbage(config);
+
+  sub["k2"] = 2;
+  EXPECT_EQ(2, config["sub"]["k2"].as<int>());
+  config.remove("sub");
+  CollectGarbage(config);
+  EXPECT_EQ(1, sub["k"].as<int>());
+  EXPECT_EQ(2, sub.size());
+}
+
+TEST(NodeTest, CollectGarbageFreesOrphans) {
+  Node node;
+  node["keep"] = "x";
+  CollectGarbage(node);
+
+  // a node for the sequence, each element, and the key
+  node["removed"] = std::vector<int>(10, 1);
+  node.remove("removed");
+  EXPECT_LE(12, CollectGarbage(node));
+
+  node["reassigned"] = std::vector<int>(10, 1);
+  CollectGarbage(node);
+  node["reassigned"] = 1;
+  EXPECT_LE(11, CollectGarbage(node));
+
+  // a key and an undefined value each
+  for (int i = 0; i < 50; i++)
+    node["missing" + std::to_string(i)];
+  EXPECT_EQ(100, CollectGarbage(node));
+  EXPECT_EQ(0, CollectGarbage(node));
+  EXPECT_EQ(2, node.size());
+  EXPECT_EQ("x", node["keep"].as<std::string>());
+}
+
+TEST(NodeTest, CollectGarbageKeepsPendingLookups) {
+  Node node;
+  Node pending = node["pending"];
+  Node nested = node["outer"]["inner"];
+  EXPECT_EQ(0, CollectGarbage(node));
+
+  pending = 1;
+  nested = 2;
+  EXPECT_EQ(1, node["pending"].as<int>());
+  EXPECT_EQ(2, node["outer"]["inner"].as<int>());
+
+  // looking into a missing key makes a map of it, even if nothing is added
+  node["probed"]["key"];
+  CollectGarbage(node);
+  EXPECT_THROW(node["probed"].push_back(1), BadPushback);
+}
+
+TEST(NodeTest, CollectGarbageOnceGrown) {
+  Node node;
+  node["a"] = std::vector<int>(10, 1);
+  CollectGarbage(node);
+
+  node["a"] = 1;
+  EXPECT_EQ(0, CollectGarbage(node, 1.0));
+  for (int i = 0; i < 20; i++)
+    node["a"] = i;
+  EXPECT_LT(0, CollectGarbage(node, 1.0));
+  EXPECT_EQ(19, node["a"].as<int>());
+}
+
 class NodeEmitterTest : public ::testing::Test {
  protected:
   void ExpectOutput(const std::string& output, const Node& node) {
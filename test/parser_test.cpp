@@ -1,14 +1,88 @@
 #include <yaml-cpp/depthguard.h>
+#include "structuralindex.h"
+#include "yaml-cpp/eventcursor.h"
+#include "yaml-cpp/eventhandler.h"
 #include "yaml-cpp/parser.h"
 #include "yaml-cpp/exceptions.h"
 #include "mock_event_handler.h"
 #include "gtest/gtest.h"
 
+using YAML::Event;
+using YAML::EventCursor;
 using YAML::Parser;
 using YAML::MockEventHandler;
 using ::testing::NiceMock;
 using ::testing::StrictMock;
 
+namespace {
+// writes out each event, and its mark, so that two parses can be compared
+class RecordingEventHandler : public YAML::EventHandler {
+ public:
+  std::string events;
+
+  void OnDocumentStart(const YAML::Mark& mark) override {
+    Record("+doc", mark);
+  }
+  void OnDocumentEnd() override { events += "-doc\n"; }
+  void OnNull(const YAML::Mark& mark, YAML::anchor_t) override {
+    Record("null", mark);
+  }
+  void OnAlias(const YAML::Mark& mark, YAML::anchor_t) override {
+    Record("alias", mark);
+  }
+  void OnScalar(const YAML::Mark& mark, const std::string& tag,
+                YAML::anchor_t, const std::string& value) override {
+    Record("scalar " + tag + " " + value, mark);
+  }
+  void OnSequenceStart(const YAML::Mark& mark, const std::string& tag,
+                       YAML::anchor_t,
+                       YAML::EmitterStyle::value style) override {
+    Record("+seq " + tag + " " + std::to_string(style), mark);
+  }
+  void OnSequenceEnd() override { events += "-seq\n"; }
+  void OnMapStart(const YAML::Mark& mark, const std::string& tag,
+                  YAML::anchor_t, YAML::EmitterStyle::value style) override {
+    Record("+map " + tag + " " + std::to_string(style), mark);
+  }
+  void OnMapEnd() override { events += "-map\n"; }
+
+ private:
+  void Record(const std::string& event, const YAML::Mark& mark) {
+    events += event + " @" + std::to_string(mark.pos) + ":" +
+              std::to_string(mark.line) + ":" + std::to_string(mark.column) +
+              "\n";
+  }
+};
+
+// the events of every document, or the error, read through the scanner
+std::string ParseStream(const std::string& input) {
+  std::istringstream stream{input};
+  RecordingEventHandler handler;
+  try {
+    Parser parser{stream};
+    while (parser.HandleNextDocument(handler)) {
+    }
+  } catch (const YAML::Exception& e) {
+    return handler.events + e.what();
+  }
+  return handler.events;
+}
+
+// the same, read from memory, through the structural index if it can be
+std::string ParseMemory(const std::string& input) {
+  RecordingEventHandler handler;
+  try {
+    Parser parser;
+    parser.Load(input.data(), input.size());
+    while (parser.HandleNextDocument(handler)) {
+    }
+  } catch (const YAML::Exception& e) {
+    return handler.events + e.what();
+  }
+  return handler.events;
+}
+}  // namespace
+
 TEST(ParserTest, Empty) {
     Parser parser;
 
@@ -62,3 +136,228 @@ TEST(ParserTest, CVE_2019_6285) {
     NiceMock<MockEventHandler> handler;
     EXPECT_THROW(parser.HandleNextDocument(handler), YAML::DeepRecursion);
 }
+
+TEST(ParserTest, DeeplyNestedFlowCollections) {
+    std::string nested;
+    for (auto i = 0; i != 5000; ++i)
+        nested += i % 2 ? "{a: " : "[";
+    for (auto i = 5000; i != 0; --i)
+        nested += i % 2 ? "]" : "}";
+    std::istringstream input{nested};
+    Parser parser{input};
+
+    NiceMock<MockEventHandler> handler;
+    EXPECT_CALL(handler, OnSequenceEnd()).Times(2500);
+    EXPECT_CALL(handler, OnMapEnd()).Times(2500);
+    EXPECT_TRUE(parser.HandleNextDocument(handler));
+}
+
+TEST(ParserTest, DeeplyNestedBlockCollections) {
+    std::string nested;
+    for (auto i = 0; i != 1000; ++i)
+        nested += std::string(static_cast<std::size_t>(i), ' ') + "a:\n";
+    std::istringstream input{nested};
+    Parser parser{input};
+
+    NiceMock<MockEventHandler> handler;
+    EXPECT_CALL(handler, OnMapEnd()).Times(1000);
+    EXPECT_TRUE(parser.HandleNextDocument(handler));
+}
+
+TEST(ParserTest, SetMaxDepth) {
+    std::string nested = "[[[[a]]]]\n---\n[[[a]]]\n";
+    std::istringstream input{nested};
+    Parser parser{input};
+    parser.SetMaxDepth(3);
+
+    NiceMock<MockEventHandler> handler;
+    EXPECT_THROW(parser.HandleNextDocument(handler), YAML::DeepRecursion);
+
+    std::istringstream shallow{"[[[a]]]"};
+    parser.Load(shallow);
+    EXPECT_TRUE(parser.HandleNextDocument(handler));
+}
+
+TEST(ParserTest, SetMaxAnchors) {
+    std::istringstream input{"[&a 1, &b 2, &a 3]\n---\n[&a 1, *a, &b 2, *b]\n"};
+    Parser parser{input};
+    parser.SetMaxAnchors(2);
+
+    NiceMock<MockEventHandler> handler;
+    EXPECT_THROW(parser.HandleNextDocument(handler), YAML::ParserException);
+
+    std::istringstream aliased{"[&a 1, *a, &b 2, *b]"};
+    parser.Load(aliased);
+    EXPECT_TRUE(parser.HandleNextDocument(handler));
+}
+
+TEST(EventCursorTest, ReadsEvents) {
+    std::istringstream input{"a: [1, &x b]\nc: *x\n"};
+    Parser parser{input};
+    EventCursor cursor{parser};
+
+    EXPECT_EQ(Event::Type::DocumentStart, cursor.next().type);
+    EXPECT_EQ(Event::Type::MapStart, cursor.next().type);
+    EXPECT_EQ("a", cursor.next().value);
+
+    const Event& seq = cursor.next();
+    EXPECT_EQ(Event::Type::SequenceStart, seq.type);
+    EXPECT_EQ(YAML::EmitterStyle::Flow, seq.style);
+    EXPECT_EQ(0, seq.mark.line);
+    EXPECT_EQ(3, seq.mark.column);
+
+    EXPECT_EQ("1", cursor.next().value);
+    const Event& anchored = cursor.next();
+    EXPECT_EQ(Event::Type::Scalar, anchored.type);
+    EXPECT_EQ("?", anchored.tag);
+    EXPECT_EQ("b", anchored.value);
+    EXPECT_EQ(1u, anchored.anchor);
+    EXPECT_EQ(Event::Type::SequenceEnd, cursor.next().type);
+
+    EXPECT_EQ("c", cursor.next().value);
+    const Event& alias = cursor.next();
+    EXPECT_EQ(Event::Type::Alias, alias.type);
+    EXPECT_EQ(1u, alias.anchor);
+
+    EXPECT_EQ(Event::Type::MapEnd, cursor.next().type);
+    EXPECT_EQ(Event::Type::DocumentEnd, cursor.next().type);
+    EXPECT_EQ(Event::Type::StreamEnd, cursor.next().type);
+    EXPECT_EQ(Event::Type::StreamEnd, cursor.next().type);
+}
+
+TEST(EventCursorTest, ReadsEachDocument) {
+    std::istringstream input{"%TAG !e! tag:e/\n--- !e!x a\n--- !e!x b\n"};
+    Parser parser{input};
+    EventCursor cursor{parser};
+
+    for (const char* value : {"a", "b"}) {
+        EXPECT_EQ(Event::Type::DocumentStart, cursor.next().type);
+        const Event& scalar = cursor.next();
+        EXPECT_EQ("tag:e/x", scalar.tag);
+        EXPECT_EQ(value, scalar.value);
+        EXPECT_EQ(Event::Type::DocumentEnd, cursor.next().type);
+    }
+    EXPECT_EQ(Event::Type::StreamEnd, cursor.next().type);
+}
+
+TEST(EventCursorTest, SkipsCollections) {
+    std::istringstream input{
+        "skip: {a: [1, 2], b: &x 3}\n"
+        "also: [x: 1, [2, 3]]\n"
+        "keep: *x\n"};
+    Parser parser{input};
+    EventCursor cursor{parser};
+
+    EXPECT_EQ(Event::Type::DocumentStart, cursor.next().type);
+    EXPECT_EQ(Event::Type::MapStart, cursor.next().type);
+    EXPECT_EQ("skip", cursor.next().value);
+    EXPECT_EQ(Event::Type::MapStart, cursor.next().type);
+    cursor.skip();
+
+    EXPECT_EQ("also", cursor.next().value);
+    EXPECT_EQ(Event::Type::SequenceStart, cursor.next().type);
+    // a compact map queues its key along with its start
+    EXPECT_EQ(Event::Type::MapStart, cursor.next().type);
+    cursor.skip();
+    EXPECT_EQ(Event::Type::SequenceStart, cursor.next().type);
+    cursor.skip();
+    EXPECT_EQ(Event::Type::SequenceEnd, cursor.next().type);
+
+    // anchors in skipped parts are still registered
+    EXPECT_EQ("keep", cursor.next().value);
+    const Event& alias = cursor.next();
+    EXPECT_EQ(Event::Type::Alias, alias.type);
+    EXPECT_EQ(1u, alias.anchor);
+    EXPECT_EQ(Event::Type::MapEnd, cursor.next().type);
+}
+
+TEST(EventCursorTest, SkipsDocuments) {
+    std::istringstream input{"[a, [b]]\n--- c\n--- {d: e}\n"};
+    Parser parser{input};
+    EventCursor cursor{parser};
+
+    for (int i = 0; i < 3; i++) {
+        EXPECT_EQ(Event::Type::DocumentStart, cursor.next().type);
+        cursor.skip();
+    }
+    EXPECT_EQ(Event::Type::StreamEnd, cursor.next().type);
+}
+
+TEST(EventCursorTest, StopsEarly) {
+    // the error is never reached
+    std::istringstream input{"header: 1\n---\n[unterminated\n"};
+    Parser parser{input};
+    EventCursor cursor{parser};
+
+    EXPECT_EQ(Event::Type::DocumentStart, cursor.next().type);
+    EXPECT_EQ(Event::Type::MapStart, cursor.next().type);
+    EXPECT_EQ("header", cursor.next().value);
+    EXPECT_EQ("1", cursor.next().value);
+}
+
+TEST(EventCursorTest, ThrowsOnError) {
+    std::istringstream input{"[a, *unknown]"};
+    Parser parser{input};
+    EventCursor cursor{parser};
+
+    EXPECT_EQ(Event::Type::DocumentStart, cursor.next().type);
+    EXPECT_EQ(Event::Type::SequenceStart, cursor.next().type);
+    EXPECT_EQ("a", cursor.next().value);
+    EXPECT_THROW(cursor.next(), YAML::ParserException);
+}
+
+TEST(ParserTest, LoadFromMemoryMatchesStream) {
+    const std::string inputs[] = {
+        "{}",
+        "[]",
+        "  [ ]  \n",
+        "{\"a\": 1, \"b\": [true, false, null], \"c\": {\"d\": -2.5e3}}",
+        "[\"\", \"x y\", \"a\\\"b\", \"\\\\\", \"\\/\\b\\f\\n\\r\\t\"]",
+        "[\"\\u0041\\u00e9\\u20ac\", \"caf\xc3\xa9\"]",
+        "{\n  \"a\": [\n    1,\n    2\n  ],\n  \"b\": {}\n}\n",
+        "{\r\n\t\"a\" :\t[1 , 2]\r\n}\r\n",
+        "[\":\", \",\", \"[\", \"]\", \"{\", \"}\", \"#\", \"- a\", \"&x\"]",
+        "{\"" + std::string(1100, 'k') + "\": 1}",
+        "{\"" + std::string(1000, 'k') + "\": 1}",
+        "[01, 1., .5, True, nul, abc, ~]",
+        "[\"a\tb\"]",
+        "[\"\\ud800\"]",
+        "[\"\\x41\"]",
+        "[1, 2,]",
+        "{\"a\": 1,}",
+        "[1] x",
+        "[1]\n---\n[2]\n",
+        "[1, [2, [3]]",
+        "{\"a\" 1}",
+        "[&a 1, *a]",
+        "\t[1]",
+        "- 1\n- 2\n",
+    };
+    for (const std::string& input : inputs)
+        EXPECT_EQ(ParseStream(input), ParseMemory(input)) << input;
+}
+
+TEST(ParserTest, LoadFromMemoryKeepsMaxDepth) {
+    const std::string nested = "[[[[1]]]]";
+    Parser parser;
+    parser.SetMaxDepth(3);
+    parser.Load(nested.data(), nested.size());
+
+    NiceMock<MockEventHandler> handler;
+    EXPECT_THROW(parser.HandleNextDocument(handler), YAML::DeepRecursion);
+
+    const std::string shallow = "[[[1]]]";
+    parser.Load(shallow.data(), shallow.size());
+    EXPECT_TRUE(parser.HandleNextDocument(handler));
+}
+
+TEST(StructuralIndexTest, FindsStructuralBytes) {
+    std::string input = "{\"a\": [1, \"\\\"\"]}\n";
+    input += std::string(100, ' ') + "x:y";
+    YAML::StructuralIndex index(input.data(), input.size());
+
+    const std::vector<std::uint32_t> expected = {0,  1,  3,  4,  6,  8,
+                                                 10, 11, 12, 13, 14, 15,
+                                                 16, 118};
+    EXPECT_EQ(expected, index.positions());
+}
@@ -174,4 +174,31 @@ TEST(RegExTest, StringOr) {
 
   EXPECT_EQ(1, ex.Match(str));
 }
+TEST(RegExTest, CanStartWith) {
+  RegEx ex = (RegEx('a') | RegEx('c', 'e')) + RegEx('x');
+  for (int i = MIN_CHAR; i < 128; ++i) {
+    EXPECT_EQ(i == 'a' || ('c' <= i && i <= 'e'), ex.CanStartWith(char(i)));
+  }
+}
+
+TEST(RegExTest, CanStartWithSkipsEmptyPrefix) {
+  RegEx ex = (RegEx('a') | RegEx()) + RegEx('b');
+  EXPECT_TRUE(ex.CanStartWith('a'));
+  EXPECT_TRUE(ex.CanStartWith('b'));
+  EXPECT_TRUE(ex.CanStartWith(Stream::eof()));
+  EXPECT_FALSE(ex.CanStartWith('c'));
+}
+
+TEST(RegExTest, CanStartWithAndNot) {
+  RegEx both = RegEx("abc", YAML::REGEX_OR) & RegEx("bcd", YAML::REGEX_OR);
+  EXPECT_FALSE(both.CanStartWith('a'));
+  EXPECT_TRUE(both.CanStartWith('b'));
+  EXPECT_TRUE(both.CanStartWith('c'));
+  EXPECT_FALSE(both.CanStartWith('d'));
+
+  RegEx notA = !RegEx('a');
+  for (int i = MIN_CHAR; i < 128; ++i) {
+    EXPECT_TRUE(notA.CanStartWith(char(i)));
+  }
+}
 }  // namespace
@@ -0,0 +1,84 @@
+#include <sstream>
+#include <string>
+
+#include "scanner.h"
+#include "yaml-cpp/exceptions.h"
+#include "gtest/gtest.h"
+
+using YAML::Scanner;
+
+namespace {
+// depth levels of block maps, then as many of block sequences, all indented
+// by indent
+std::string Nested(int depth, int indent) {
+  std::string nested;
+  for (int i = 0; i < depth; i++)
+    nested +=
+        std::string(indent + 2 * i, ' ') + "k" + std::to_string(i) + ":\n";
+  for (int i = 0; i < depth; i++)
+    nested += std::string(indent + 2 * (depth + i), ' ') + "-\n";
+  nested += std::string(indent + 4 * depth, ' ') + "leaf\n";
+  return nested;
+}
+
+void ExpectAllIndentMarkersAccountedFor(const Scanner& scanner) {
+  EXPECT_EQ(scanner.IndentMarkersAllocated(),
+            scanner.IndentMarkersInUse() + scanner.IndentMarkersRetired() +
+                scanner.IndentMarkersFree());
+}
+
+TEST(ScannerTest, ReusesIndentMarkers) {
+  const int depth = 20;
+  const int count = 50;
+  std::string input;
+  for (int document = 0; document < 2; document++) {
+    input += "---\n";
+    for (int i = 0; i < count; i++)
+      input += "r" + std::to_string(i) + ":\n" + Nested(depth, 2);
+  }
+
+  std::istringstream stream(input);
+  Scanner scanner(stream);
+  std::size_t firstAllocated = 0;
+  std::size_t mostAllocated = 0;
+  int ends = 0;
+  while (!scanner.empty()) {
+    // the first nested block is over once its collections have all ended
+    if (scanner.peek().type == YAML::Token::BLOCK_MAP_END ||
+        scanner.peek().type == YAML::Token::BLOCK_SEQ_END) {
+      if (++ends == 2 * depth)
+        firstAllocated = scanner.IndentMarkersAllocated();
+    }
+    if (scanner.IndentMarkersAllocated() > mostAllocated)
+      mostAllocated = scanner.IndentMarkersAllocated();
+    ExpectAllIndentMarkersAccountedFor(scanner);
+    scanner.pop();
+  }
+
+  // one for the stream, one for the top-level map, one per level, and one
+  // for the leaf, which might have started a map
+  EXPECT_LE(mostAllocated, static_cast<std::size_t>(2 * depth + 3));
+  EXPECT_EQ(firstAllocated, scanner.IndentMarkersAllocated());
+
+  // all but the stream's are free again
+  EXPECT_EQ(1, scanner.IndentMarkersInUse());
+  EXPECT_EQ(0, scanner.IndentMarkersRetired());
+}
+
+TEST(ScannerTest, KeepsRetiredIndentMarkersOnError) {
+  // the anchor's simple key is still pending when the sequence's marker is
+  // popped, so that marker is retired rather than freed when the error hits
+  std::istringstream stream("&x a\n- b\n]");
+  Scanner scanner(stream);
+  EXPECT_THROW(
+      {
+        while (!scanner.empty())
+          scanner.pop();
+      },
+      YAML::ParserException);
+
+  // the scanner still owns it, so it's freed along with the scanner
+  EXPECT_EQ(1, scanner.IndentMarkersRetired());
+  ExpectAllIndentMarkersAccountedFor(scanner);
+}
+}  // namespace
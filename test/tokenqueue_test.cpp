@@ -0,0 +1,60 @@
+#include "tokenqueue.h"
+#include "gtest/gtest.h"
+
+using YAML::Mark;
+using YAML::Token;
+using YAML::TokenQueue;
+
+namespace {
+TEST(TokenQueueTest, FirstInFirstOut) {
+  TokenQueue queue;
+  EXPECT_TRUE(queue.empty());
+
+  // enough to wrap around and grow the ring a few times
+  int pushed = 0;
+  int popped = 0;
+  for (int round = 0; round < 10; round++) {
+    for (int i = 0; i < 7 * round; i++) {
+      queue.push(Token::PLAIN_SCALAR, Mark()).data = pushed++;
+      EXPECT_EQ(pushed - 1, queue.back().data);
+    }
+    for (int i = 0; i < 3 * round; i++) {
+      EXPECT_EQ(popped++, queue.front().data);
+      queue.pop();
+    }
+  }
+  EXPECT_EQ(static_cast<std::size_t>(pushed - popped), queue.size());
+  while (!queue.empty()) {
+    EXPECT_EQ(popped++, queue.front().data);
+    queue.pop();
+  }
+}
+
+TEST(TokenQueueTest, RecyclesTokens) {
+  TokenQueue queue;
+  Token& first = queue.push(Token::DIRECTIVE, Mark());
+  first.status = Token::INVALID;
+  first.value = "a value too long to fit in a short string";
+  first.params.push_back("param");
+  first.data = 1;
+  const std::size_t capacity = first.value.capacity();
+  queue.pop();
+
+  Token& second = queue.push(Token::KEY, Mark());
+  EXPECT_EQ(&first, &second);
+  EXPECT_EQ(Token::VALID, second.status);
+  EXPECT_EQ(Token::KEY, second.type);
+  EXPECT_TRUE(second.value.empty());
+  EXPECT_EQ(capacity, second.value.capacity());
+  EXPECT_TRUE(second.params.empty());
+  EXPECT_EQ(0, second.data);
+}
+
+TEST(TokenQueueTest, TokensStayPut) {
+  TokenQueue queue;
+  Token* pFirst = &queue.push(Token::KEY, Mark());
+  for (int i = 0; i < 100; i++)
+    queue.push(Token::VALUE, Mark());
+  EXPECT_EQ(pFirst, &queue.front());
+}
+}  // namespace